@@ -0,0 +1,126 @@
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/homomorphicEvaluation.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+// Usage: Calibration [max threads] [samples per thread] [output file]
+// Every operation is timed at 1..max threads; each thread works on its own ciphertexts
+// with the shared cloud key, as the parallel executor does. Both counts have to be positive.
+
+typedef chrono::steady_clock Clock;
+
+FheContext context;
+
+struct Measurement {
+    double mean, deviation, p50, p90, p99, throughput;
+};
+
+void RunOperation(Operation operation, LweSample *a, LweSample *b, LweSample *c, LweSample *result) {
+    switch(operation) {
+        case Operation::Mux: bootsMUX(result, a, b, c, context.cloudKey); break;
+        case Operation::Not: bootsNOT(result, a, context.cloudKey); break;
+        case Operation::Copy: bootsCOPY(result, a, context.cloudKey); break;
+        case Operation::Encrypt: context.Encrypt(result, rand() % 2); break;
+        case Operation::Decrypt: context.Decrypt(a); break;
+        default: BootsGate(operation, result, a, b, context.cloudKey); break;
+    }
+}
+
+void Worker(Operation operation, int samples, double *latencies) {
+    LweSample *ciphertexts = new_gate_bootstrapping_ciphertext_array(4, context.params);
+
+    for(int i = 0; i < 3; i++) {
+        context.Encrypt(&ciphertexts[i], i % 2);
+    }
+
+    for(int i = 0; i < samples; i++) {
+        Clock::time_point start = Clock::now();
+
+        RunOperation(operation, &ciphertexts[0], &ciphertexts[1], &ciphertexts[2], &ciphertexts[3]);
+
+        latencies[i] = chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    delete_gate_bootstrapping_ciphertext_array(4, ciphertexts);
+}
+
+double Percentile(const vector<double> &sorted, double p) {
+    size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+
+    return sorted[index];
+}
+
+Measurement Measure(Operation operation, int threads, int samples) {
+    vector<double> latencies(threads * samples);
+    vector<thread> workers;
+    Measurement measurement;
+
+    Clock::time_point start = Clock::now();
+
+    for(int i = 0; i < threads; i++) {
+        workers.push_back(thread(Worker, operation, samples, &latencies[i * samples]));
+    }
+
+    for(int i = 0; i < threads; i++) {
+        workers[i].join();
+    }
+
+    double wall = chrono::duration<double>(Clock::now() - start).count();
+
+    double sum = 0, squares = 0;
+    for(size_t i = 0; i < latencies.size(); i++) {
+        sum += latencies[i];
+        squares += latencies[i] * latencies[i];
+    }
+
+    sort(latencies.begin(), latencies.end());
+
+    measurement.mean = sum / latencies.size();
+    measurement.deviation = sqrt(max(squares / latencies.size() - measurement.mean * measurement.mean, 0.0));
+    measurement.p50 = Percentile(latencies, 0.5);
+    measurement.p90 = Percentile(latencies, 0.9);
+    measurement.p99 = Percentile(latencies, 0.99);
+    measurement.throughput = wall > 0 ? latencies.size() / wall : 0;
+
+    return measurement;
+}
+
+int main(int argc, char **argv) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : max((int)thread::hardware_concurrency(), 1);
+    int samples = argc > 2 ? atoi(argv[2]) : 100;
+    const char *path = argc > 3 ? argv[3] : "calibration.txt";
+
+    if(maxThreads < 1 || samples < 1) {
+        cerr<<"Usage: Calibration [max threads] [samples per thread] [output file], with positive counts"<<endl;
+        return 1;
+    }
+
+    context.Generate();
+
+    ofstream out(path);
+
+    out<<"# operation threads mean stddev p50 p90 p99 throughput"<<endl;
+    out<<"# latencies in seconds per operation while all threads run, throughput in operations per second over all threads"<<endl;
+
+    for(int i = 0; i < operationKinds; i++) {
+        for(int threads = 1; threads <= maxThreads; threads++) {
+            Measurement m = Measure((Operation)i, threads, samples);
+
+            out<<OperationName((Operation)i)<<" "<<threads<<" "<<m.mean<<" "<<m.deviation<<" "
+                <<m.p50<<" "<<m.p90<<" "<<m.p99<<" "<<m.throughput<<endl;
+            cout<<OperationName((Operation)i)<<" x"<<threads<<": "<<m.mean<<" s, "<<m.throughput<<" ops/s"<<endl;
+        }
+    }
+
+    return 0;
+}
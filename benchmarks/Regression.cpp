@@ -0,0 +1,289 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <map>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/sortingNetworks.h"
+#include "../include/encryptedSearch.h"
+#include "../include/accumulator.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+// Usage: Regression [baseline file] [--update]
+// Runs every GenericInt32 operator and the sorting and searching workloads on each simulated
+// backend and prints gates, bootstraps, depth and estimated seconds per case as JSON. Every
+// case is compared with the baseline (benchmarks/baseline.json by default): more gates,
+// bootstraps or depth than the baseline is a regression, and so is a case missing from the
+// baseline or a baseline case no longer measured; any of them makes the exit status 1.
+// --update writes the current counts to the baseline instead.
+
+const int inputCount = 10;
+const long long levelledDepth = 16;
+const long long constant = 12345;
+
+const char *caseNames[] = {
+    "==", "!=", ">", "<", ">=", "<=", "~", "&", "|", "^", "+", "+ bit", "++", "-", "*", "/", "%",
+    "== constant", "!= constant", "> constant", "< constant", ">= constant", "<= constant",
+    "& constant", "| constant", "^ constant", "+ constant", "- constant", "* constant", "/ constant", "% constant",
+    "oddEvenMergeSort", "bitonicSort", "topK 3", "contains", "popcount equalAll", "lookup", "sum"
+};
+const int caseCount = sizeof(caseNames) / sizeof(caseNames[0]);
+
+struct Result {
+    long long gates, bootstraps, depth;
+    double seconds;
+};
+
+// Operators take the first two inputs; the workloads take all of them, the last input
+// being the key of the searches
+struct Case {
+    int k;
+
+    template <class BoolType>
+    void operator()(vector<GenericInt32<BoolType> > v) const {
+        GenericInt32<BoolType> &x = v[0], &y = v[1], &key = v[inputCount - 1];
+        vector<GenericInt32<BoolType> > records(v.begin(), v.end() - 1);
+
+        switch(k) {
+            case 0: x == y; break;
+            case 1: x != y; break;
+            case 2: x > y; break;
+            case 3: x < y; break;
+            case 4: x >= y; break;
+            case 5: x <= y; break;
+            case 6: ~x; break;
+            case 7: x & y; break;
+            case 8: x | y; break;
+            case 9: x ^ y; break;
+            case 10: x + y; break;
+            case 11: x + y.encValue[0]; break;
+            case 12: x++; break;
+            case 13: x - y; break;
+            case 14: x * y; break;
+            case 15: x / y; break;
+            case 16: x % y; break;
+            case 17: x == constant; break;
+            case 18: x != constant; break;
+            case 19: x > constant; break;
+            case 20: x < constant; break;
+            case 21: x >= constant; break;
+            case 22: x <= constant; break;
+            case 23: x & constant; break;
+            case 24: x | constant; break;
+            case 25: x ^ constant; break;
+            case 26: x + constant; break;
+            case 27: x - constant; break;
+            case 28: x * constant; break;
+            case 29: x / constant; break;
+            case 30: x % constant; break;
+            case 31: oddEvenMergeSort(v); break;
+            case 32: bitonicSort(v); break;
+            case 33: topK(v, 3); break;
+            case 34: contains(key, records); break;
+            case 35: popcount<32>(equalAll(key, records)); break;
+            case 36: lookup(records, x.template Truncate<4>()); break;
+            case 37: sum(v); break;
+        }
+    }
+};
+
+template <class BoolType>
+void Initialize(GenericInt32<BoolType> &a, long long n, Computation &routine) {
+    a.Initialize(n, routine);
+}
+
+void Initialize(GenericInt32<SimulatedLevelledBit> &a, long long n, Computation &routine) {
+    a.Initialize(n, levelledDepth, routine);
+}
+
+// Gates are the bootstrapped operations, NOTs being free; the time prices every bootstrap
+// of the backend as a TFHE gate bootstrap. Only ProfiledBit fills the depth.
+template <class BoolType>
+Result Measure(const Case &run) {
+    Computation routine;
+    vector<GenericInt32<BoolType> > values(inputCount);
+    Result result;
+
+    for(int i = 0; i < inputCount; i++) {
+        Initialize(values[i], (i * 2654435761LL + 97) % 4294967296LL, routine);
+    }
+
+    run(values);
+
+    result.gates = 0;
+
+    for(int i = (int)Operation::And; i <= (int)Operation::Mux; i++) {
+        result.gates += routine.GetCount((Operation)i);
+    }
+
+    result.bootstraps = routine.GetBootstrapping();
+    result.depth = routine.GetDepth();
+    result.seconds = result.bootstraps * CostModel::TfheGate().secondsPerBootstrap;
+
+    return result;
+}
+
+// Reads the number or the string after "key": on a line of the baseline
+bool ReadField(const string &line, const string &key, string &value) {
+    size_t start = line.find("\"" + key + "\": ");
+
+    if(start == string::npos) {
+        return false;
+    }
+
+    start += key.size() + 4;
+
+    if(line[start] == '"') {
+        size_t end = line.find('"', start + 1);
+        value = line.substr(start + 1, end - start - 1);
+    }
+    else {
+        value = line.substr(start, line.find_first_of(",}", start) - start);
+    }
+
+    return true;
+}
+
+bool ReadBaseline(const char *path, map<string, Result> &baseline) {
+    ifstream in(path);
+    string line;
+
+    if(!in) {
+        return false;
+    }
+
+    while(getline(in, line)) {
+        string name, backend, gates, bootstraps, depth, seconds;
+
+        if(ReadField(line, "case", name) && ReadField(line, "backend", backend) && ReadField(line, "gates", gates)
+            && ReadField(line, "bootstraps", bootstraps) && ReadField(line, "depth", depth) && ReadField(line, "seconds", seconds)) {
+            Result result;
+
+            result.gates = atoll(gates.c_str());
+            result.bootstraps = atoll(bootstraps.c_str());
+            result.depth = atoll(depth.c_str());
+            result.seconds = atof(seconds.c_str());
+            baseline[name + " " + backend] = result;
+        }
+    }
+
+    return true;
+}
+
+void WriteRow(ostream &out, const string &name, const string &backend, const Result &result) {
+    out<<"{\"case\": \""<<name<<"\", \"backend\": \""<<backend<<"\", \"gates\": "<<result.gates
+        <<", \"bootstraps\": "<<result.bootstraps<<", \"depth\": "<<result.depth<<", \"seconds\": "<<result.seconds<<"}";
+}
+
+int main(int argc, char **argv) {
+    const char *path = "benchmarks/baseline.json";
+    bool update = false;
+
+    for(int i = 1; i < argc; i++) {
+        if(string(argv[i]) == "--update") {
+            update = true;
+        }
+        else {
+            path = argv[i];
+        }
+    }
+
+    map<string, Result> baseline;
+
+    if(!update && !ReadBaseline(path, baseline)) {
+        cerr<<"Cannot read the baseline "<<path<<"; run with --update to create it"<<endl;
+        return 1;
+    }
+
+    vector<string> names, backends;
+    vector<Result> results;
+
+    for(int k = 0; k < caseCount; k++) {
+        Case run = {k};
+        Result profiled = Measure<ProfiledBit>(run);
+        Result measured[] = { Measure<SimulatedGateBootstrappedBit>(run), Measure<SimulatedCircuitBootstrappedBit>(run),
+            Measure<SimulatedLevelledBit>(run), profiled };
+        const char *backendNames[] = { "gate", "circuit", "levelled", "profiled" };
+
+        for(int i = 0; i < 4; i++) {
+            measured[i].depth = profiled.depth;
+            names.push_back(string("GenericInt32 ") + caseNames[k]);
+            backends.push_back(backendNames[i]);
+            results.push_back(measured[i]);
+        }
+    }
+
+    if(update) {
+        ofstream out(path);
+
+        out<<"{\"cases\": ["<<endl;
+
+        for(size_t i = 0; i < results.size(); i++) {
+            WriteRow(out, names[i], backends[i], results[i]);
+            out<<(i + 1 < results.size() ? "," : "")<<endl;
+        }
+
+        out<<"]}"<<endl;
+        cout<<"Wrote "<<results.size()<<" cases to "<<path<<endl;
+
+        return 0;
+    }
+
+    int regressions = 0, added = 0, removed = 0;
+
+    cout<<"{\"cases\": ["<<endl;
+
+    for(size_t i = 0; i < results.size(); i++) {
+        map<string, Result>::iterator it = baseline.find(names[i] + " " + backends[i]);
+        string status = "new";
+
+        if(it != baseline.end()) {
+            const Result &old = it->second;
+
+            if(results[i].gates > old.gates || results[i].bootstraps > old.bootstraps || results[i].depth > old.depth) {
+                status = "regression";
+                regressions++;
+            }
+            else if(results[i].gates < old.gates || results[i].bootstraps < old.bootstraps || results[i].depth < old.depth) {
+                status = "improved";
+            }
+            else {
+                status = "unchanged";
+            }
+
+            cout<<"{\"baseline\": ";
+            WriteRow(cout, names[i], backends[i], old);
+            cout<<", \"current\": ";
+            baseline.erase(it);
+        }
+        else {
+            cout<<"{\"current\": ";
+            added++;
+        }
+
+        WriteRow(cout, names[i], backends[i], results[i]);
+        cout<<", \"status\": \""<<status<<"\"}"<<(i + 1 < results.size() || !baseline.empty() ? "," : "")<<endl;
+    }
+
+    // What is left of the baseline is no longer measured, as when a case is renamed
+    for(map<string, Result>::iterator it = baseline.begin(); it != baseline.end(); it++) {
+        size_t split = it->first.rfind(' ');
+
+        cout<<"{\"baseline\": ";
+        WriteRow(cout, it->first.substr(0, split), it->first.substr(split + 1), it->second);
+        cout<<", \"status\": \"removed\"}"<<(++removed < (int)baseline.size() ? "," : "")<<endl;
+    }
+
+    cout<<"], \"regressions\": "<<regressions<<", \"new\": "<<added<<", \"removed\": "<<removed<<"}"<<endl;
+
+    if(added > 0 || removed > 0) {
+        cerr<<"The cases differ from the baseline; run with --update to accept them"<<endl;
+    }
+
+    return regressions > 0 || added > 0 || removed > 0;
+}
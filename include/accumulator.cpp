@@ -0,0 +1,74 @@
+template <int N, class BoolType>
+GenericInt<N, BoolType> popcount(const std::vector<BoolType> &bits, AdderType adder) {
+    std::vector<std::vector<FoldedBit<BoolType> > > columns(N);
+    GenericInt<N, BoolType> result;
+
+    for (size_t i = 0; i < bits.size(); i++)
+        columns[0].push_back(FoldedBit<BoolType>::Wire(bits[i]));
+
+    result.adder = adder;
+
+    return result.FromFoldedBits(ReduceColumns(columns, MultiplierType::Dadda, adder));
+}
+
+// Sum modulo 2^N, with the adder of the first value
+template <int N, class BoolType>
+GenericInt<N, BoolType> sum(const std::vector<GenericInt<N, BoolType> > &values) {
+    std::vector<std::vector<FoldedBit<BoolType> > > columns(N);
+
+    if (values.empty())
+        return GenericInt<N, BoolType>(0);
+
+    for (size_t j = 0; j < values.size(); j++)
+    {
+        std::array<FoldedBit<BoolType>, N> bits = values[j].GetFoldedBits();
+
+        for (int i = 0; i < N; i++)
+            columns[i].push_back(bits[i]);
+    }
+
+    return values[0].FromFoldedBits(ReduceColumns(columns, MultiplierType::Dadda, values[0].adder));
+}
+
+template <int N, class BoolType>
+Accumulator<N, BoolType>::Accumulator(size_t newMaximumHeight) : columns(N) {
+    adder = AdderPolicy<BoolType>::type;
+    maximumHeight = std::max(newMaximumHeight, (size_t)3);
+}
+
+template <int N, class BoolType>
+void Accumulator<N, BoolType>::Add(const BoolType &bit) {
+    columns[0].push_back(FoldedBit<BoolType>::Wire(bit));
+
+    if (columns[0].size() > maximumHeight)
+        Compress();
+}
+
+template <int N, class BoolType>
+void Accumulator<N, BoolType>::Add(const GenericInt<N, BoolType> &value) {
+    std::array<FoldedBit<BoolType>, N> bits = value.GetFoldedBits();
+    bool full = false;
+
+    for (int i = 0; i < N; i++)
+    {
+        columns[i].push_back(bits[i]);
+        full |= columns[i].size() > maximumHeight;
+    }
+
+    if (full)
+        Compress();
+}
+
+template <int N, class BoolType>
+void Accumulator<N, BoolType>::Compress() {
+    CompressColumns(columns, MultiplierType::Dadda);
+}
+
+template <int N, class BoolType>
+GenericInt<N, BoolType> Accumulator<N, BoolType>::GetSum() const {
+    GenericInt<N, BoolType> result;
+
+    result.adder = adder;
+
+    return result.FromFoldedBits(ReduceColumns(columns, MultiplierType::Dadda, adder));
+}
@@ -0,0 +1,35 @@
+#ifndef HOMOMORPHIC_ENCRYPTION_ACCUMULATOR_H
+#define HOMOMORPHIC_ENCRYPTION_ACCUMULATOR_H
+
+#include <vector>
+#include "homomorphicEvaluation.h"
+
+namespace homomorphicEvaluation {
+    // COUNT of the set bits and SUM of N-bit values as one carry-save compressor tree over
+    // all operands and a single carry-propagate addition. A popcount only fills the lowest
+    // log2(count) + 1 columns, and the constant columns above fold away.
+    template <int N, class BoolType> GenericInt<N, BoolType> popcount(const std::vector<BoolType>& bits, AdderType adder = AdderPolicy<BoolType>::type);
+    template <int N, class BoolType> GenericInt<N, BoolType> sum(const std::vector<GenericInt<N, BoolType> >& values);
+
+    // Running COUNT or SUM over a stream, such as the records of an encrypted column. Operands
+    // are kept in carry-save form as bit columns; once a column grows past maximumHeight all
+    // columns are compressed back to two rows, so memory stays bounded and each batch is a
+    // log-depth tree. GetSum pays the one carry-propagate addition.
+    template <int N, class BoolType> class Accumulator {
+    public:
+        AdderType adder;
+        size_t maximumHeight;
+        Accumulator(size_t newMaximumHeight = 64);
+        void Add(const BoolType& bit);
+        void Add(const GenericInt<N, BoolType>& value);
+        GenericInt<N, BoolType> GetSum() const;
+    private:
+        std::vector<std::vector<FoldedBit<BoolType> > > columns;
+        void Compress();
+    };
+
+    // accumulator.cpp includes the compressor trees and the accumulator
+    #include "accumulator.cpp"
+};
+
+#endif
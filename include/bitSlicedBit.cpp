@@ -0,0 +1,93 @@
+bool BitSlicedBit::GetLane(int lane) const {
+    return (words[lane / 64] >> (lane % 64)) & 1;
+}
+
+void BitSlicedBit::SetLane(int lane, bool n) {
+    uint64_t mask = 1ULL << (lane % 64);
+
+    words[lane / 64] = n ? words[lane / 64] | mask : words[lane / 64] & ~mask;
+}
+
+BitSlicedBit ApplyGate(Operation operation, const BitSlicedBit &a, const BitSlicedBit &b) {
+    BitSlicedBit c;
+
+    for (int i = 0; i < bitSliceWords; i++)
+    {
+        uint64_t x = a.words[i], y = b.words[i];
+
+        switch (operation)
+        {
+            case Operation::And: c.words[i] = x & y; break;
+            case Operation::Or: c.words[i] = x | y; break;
+            case Operation::Xor: c.words[i] = x ^ y; break;
+            case Operation::Xnor: c.words[i] = ~(x ^ y); break;
+            case Operation::Nand: c.words[i] = ~(x & y); break;
+            case Operation::Nor: c.words[i] = ~(x | y); break;
+            case Operation::AndNY: c.words[i] = ~x & y; break;
+            case Operation::AndYN: c.words[i] = x & ~y; break;
+            case Operation::OrNY: c.words[i] = ~x | y; break;
+            case Operation::OrYN: c.words[i] = x | ~y; break;
+            default: c.words[i] = 0;
+        }
+    }
+
+    return c;
+}
+
+BitSlicedBit BitSlicedBit::operator&(const BitSlicedBit &a) const {
+    return ApplyGate(Operation::And, *this, a);
+}
+
+BitSlicedBit BitSlicedBit::operator^(const BitSlicedBit &a) const {
+    return ApplyGate(Operation::Xor, *this, a);
+}
+
+BitSlicedBit BitSlicedBit::operator|(const BitSlicedBit &a) const {
+    return ApplyGate(Operation::Or, *this, a);
+}
+
+BitSlicedBit BitSlicedBit::operator!() const {
+    BitSlicedBit b;
+
+    for (int i = 0; i < bitSliceWords; i++)
+        b.words[i] = ~words[i];
+
+    return b;
+}
+
+BitSlicedBit mux(BitSlicedBit a, BitSlicedBit b, BitSlicedBit c) {
+    BitSlicedBit d;
+
+    for (int i = 0; i < bitSliceWords; i++)
+        d.words[i] = (a.words[i] & b.words[i]) | (~a.words[i] & c.words[i]);
+
+    return d;
+}
+
+template <int N>
+GenericInt<N, BitSlicedBit> PackLanes(const std::vector<unsigned long long> &values) {
+    GenericInt<N, BitSlicedBit> result;
+    int count = std::min((int)values.size(), bitSliceLanes);
+
+    for (int i = 0; i < N; i++)
+    {
+        result.encValue[i] = BitSlicedBit(0);
+
+        if (i < 64)
+            for (int j = 0; j < count; j++)
+                result.encValue[i].words[j / 64] |= ((values[j] >> i) & 1) << (j % 64);
+    }
+
+    return result;
+}
+
+template <int N>
+std::vector<unsigned long long> UnpackLanes(const GenericInt<N, BitSlicedBit> &a, int count) {
+    std::vector<unsigned long long> values(std::min(count, bitSliceLanes), 0);
+
+    for (int i = 0; i < N && i < 64; i++)
+        for (size_t j = 0; j < values.size(); j++)
+            values[j] |= (unsigned long long)a.encValue[i].GetLane(j) << i;
+
+    return values;
+}
@@ -0,0 +1,49 @@
+#ifndef HOMOMORPHIC_ENCRYPTION_BIT_SLICED_BIT_H
+#define HOMOMORPHIC_ENCRYPTION_BIT_SLICED_BIT_H
+
+#include <vector>
+#include <cstdint>
+#include "homomorphicEvaluation.h"
+
+// Words per bit-sliced value: one 64-bit word by default, or as many as fill the widest
+// vector registers the compiler targets. The gate loops are plain word operations that
+// the compiler turns into AVX2 or AVX-512 instructions when they are enabled.
+#ifndef HOMOMORPHIC_BIT_SLICE_WORDS
+#if defined(__AVX512F__)
+#define HOMOMORPHIC_BIT_SLICE_WORDS 8
+#elif defined(__AVX2__)
+#define HOMOMORPHIC_BIT_SLICE_WORDS 4
+#else
+#define HOMOMORPHIC_BIT_SLICE_WORDS 1
+#endif
+#endif
+
+namespace homomorphicEvaluation {
+    const int bitSliceWords = HOMOMORPHIC_BIT_SLICE_WORDS;
+    const int bitSliceLanes = 64 * bitSliceWords;
+
+    // Plaintext bit that carries bitSliceLanes independent test vectors, lane j in bit j % 64
+    // of word j / 64, so every gate evaluates all of them at once. A bit built from a bool
+    // holds that value in every lane.
+    class BitSlicedBit {
+    public:
+        uint64_t words[bitSliceWords];
+        BitSlicedBit() { for (int i = 0; i < bitSliceWords; i++) words[i] = 0; }
+        BitSlicedBit(bool n) { for (int i = 0; i < bitSliceWords; i++) words[i] = n ? ~0ULL : 0; }
+        bool GetLane(int lane) const;
+        void SetLane(int lane, bool n);
+        BitSlicedBit operator&(const BitSlicedBit& a) const;
+        BitSlicedBit operator^(const BitSlicedBit& a) const;
+        BitSlicedBit operator|(const BitSlicedBit& a) const;
+        BitSlicedBit operator!() const;
+    };
+
+    // Lane j of the result holds values[j]; lanes past the end of values hold 0
+    template <int N> GenericInt<N, BitSlicedBit> PackLanes(const std::vector<unsigned long long>& values);
+    template <int N> std::vector<unsigned long long> UnpackLanes(const GenericInt<N, BitSlicedBit>& a, int count = bitSliceLanes);
+
+    // bitSlicedBit.cpp includes the gates and the packing helpers
+    #include "bitSlicedBit.cpp"
+};
+
+#endif
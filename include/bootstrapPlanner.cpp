@@ -0,0 +1,315 @@
+void PlannedLevelledBit::Initialize(long long newDepth, Computation &newComputation) {
+    depth = newDepth;
+    routine = &newComputation;
+    routine->Encrypt();
+}
+
+void PlannedLevelledBit::Initialize(bool n, long long newDepth, Computation &newComputation) {
+    value = n;
+    depth = newDepth;
+    routine = &newComputation;
+    routine->Encrypt();
+}
+
+void PlannedLevelledBit::Refresh() {
+    level = 0;
+
+    if (routine != NULL)
+        routine->Bootstrap();
+}
+
+PlannedLevelledBit ApplyGate(Operation operation, const PlannedLevelledBit &a, const PlannedLevelledBit &b) {
+    PlannedLevelledBit c;
+
+    c.value = GateOutput(operation, a.value, b.value);
+    c.routine = a.routine != NULL ? a.routine : b.routine;
+    c.level = std::max(a.level, b.level) + 1;
+    c.depth = a.routine != NULL ? a.depth : b.depth;
+
+    if (c.routine != NULL)
+        c.routine->Record(operation);
+
+    return c;
+}
+
+PlannedLevelledBit PlannedLevelledBit::operator&(const PlannedLevelledBit &a) const {
+    return ApplyGate(Operation::And, *this, a);
+}
+
+PlannedLevelledBit PlannedLevelledBit::operator^(const PlannedLevelledBit &a) const {
+    return ApplyGate(Operation::Xor, *this, a);
+}
+
+PlannedLevelledBit PlannedLevelledBit::operator|(const PlannedLevelledBit &a) const {
+    return ApplyGate(Operation::Or, *this, a);
+}
+
+PlannedLevelledBit PlannedLevelledBit::operator!() const {
+    PlannedLevelledBit b;
+
+    b.value = !value;
+    b.routine = routine;
+
+    if (b.routine != NULL)
+        b.routine->Record(Operation::Not);
+    b.depth = depth;
+    b.level = level;
+
+    return b;
+}
+
+PlannedLevelledBit mux(PlannedLevelledBit a, PlannedLevelledBit b, PlannedLevelledBit c) {
+    PlannedLevelledBit d;
+
+    d.value = a.value ? b.value : c.value;
+    d.routine = a.routine != NULL ? a.routine : (b.routine != NULL ? b.routine : c.routine);
+    d.level = std::max(std::max(a.level, b.level), c.level) + 1;
+    d.depth = a.routine != NULL ? a.depth : (b.routine != NULL ? b.depth : c.depth);
+
+    if (d.routine != NULL)
+        d.routine->Record(Operation::Mux);
+
+    return d;
+}
+
+bool IsComputedGate(const Circuit &circuit, int id) {
+    return circuit.gates[id].type != GateType::Input && circuit.gates[id].type != GateType::Constant;
+}
+
+// Level of a computed gate before any refresh of its own, given the levels its operands are
+// read at; a NOT is free and keeps the level of its operand
+long long PlannedLevel(const Circuit &circuit, const std::vector<long long> &levels, int id) {
+    const Gate &gate = circuit.gates[id];
+    long long level = 0;
+
+    for (int j = 0; j < 3; j++)
+        if (gate.input[j] >= 0)
+            level = std::max(level, levels[gate.input[j]]);
+
+    return gate.type == GateType::Not ? level : level + 1;
+}
+
+// Levels every gate is read at under a plan, recomputed from gate first onwards; false as
+// soon as a gate goes past what the budget allows it
+bool PlanLevels(const Circuit &circuit, const BootstrapPlan &plan, std::vector<long long> &levels, size_t first) {
+    for (size_t i = first; i < circuit.gates.size(); i++)
+    {
+        if (!IsComputedGate(circuit, i))
+        {
+            levels[i] = 0;
+            continue;
+        }
+
+        long long level = PlannedLevel(circuit, levels, i);
+
+        if (level > plan.depth + 1 || (!plan.refresh[i] && level > plan.depth))
+            return false;
+
+        levels[i] = plan.refresh[i] ? 0 : level;
+    }
+
+    return true;
+}
+
+long long BootstrapPlan::GetBootstrapping() const {
+    long long count = 0;
+
+    for (size_t i = 0; i < refresh.size(); i++)
+        count += refresh[i];
+
+    return count;
+}
+
+bool BootstrapPlan::IsValid(const Circuit &circuit) const {
+    std::vector<long long> levels(circuit.gates.size(), 0);
+
+    return refresh.size() == circuit.gates.size() && PlanLevels(circuit, *this, levels, 0);
+}
+
+// Runs the circuit gate by gate and bootstraps exactly the planned wires; false if any
+// wire goes past the depth budget on the way
+bool BootstrapPlan::Execute(const Circuit &circuit, const std::vector<PlannedLevelledBit> &inputValues, std::vector<PlannedLevelledBit> &outputValues) const {
+    std::vector<PlannedLevelledBit> values(circuit.gates.size());
+    bool valid = refresh.size() == circuit.gates.size();
+
+    outputValues.clear();
+
+    for (size_t i = 0; i < circuit.gates.size() && valid; i++)
+    {
+        const Gate &gate = circuit.gates[i];
+
+        switch (gate.type)
+        {
+            case GateType::Input:
+                values[i] = inputValues[gate.input[0]];
+                break;
+            case GateType::Constant:
+                values[i] = PlannedLevelledBit((bool)gate.input[0]);
+                break;
+            case GateType::Not:
+                values[i] = !values[gate.input[0]];
+                break;
+            case GateType::Mux:
+                values[i] = mux(values[gate.input[0]], values[gate.input[1]], values[gate.input[2]]);
+                break;
+            default:
+                values[i] = ApplyGate(OperationOf(gate.type), values[gate.input[0]], values[gate.input[1]]);
+        }
+
+        valid &= values[i].level <= depth + 1;
+
+        if (refresh[i])
+            values[i].Refresh();
+
+        valid &= values[i].level <= depth;
+    }
+
+    if (!valid)
+        return false;
+
+    for (size_t i = 0; i < circuit.outputs.size(); i++)
+        outputValues.push_back(values[circuit.outputs[i]]);
+
+    return true;
+}
+
+void BootstrapPlan::Write(std::ostream &out) const {
+    out<<"depth "<<depth<<std::endl;
+    out<<"bootstraps "<<GetBootstrapping()<<std::endl;
+    out<<"refresh";
+
+    for (size_t i = 0; i < refresh.size(); i++)
+        if (refresh[i])
+            out<<" "<<i;
+
+    out<<std::endl;
+}
+
+// Refreshes every gate whose level goes past the budget, the way SimulatedLevelledBit does
+BootstrapPlan BootstrapPlanner::Greedy(const Circuit &circuit) const {
+    BootstrapPlan plan;
+    std::vector<long long> levels(circuit.gates.size(), 0);
+
+    plan.depth = depth;
+    plan.refresh.assign(circuit.gates.size(), false);
+
+    for (size_t i = 0; i < circuit.gates.size(); i++)
+    {
+        if (!IsComputedGate(circuit, i))
+            continue;
+
+        long long level = PlannedLevel(circuit, levels, i);
+
+        plan.refresh[i] = level > depth;
+        levels[i] = plan.refresh[i] ? 0 : level;
+    }
+
+    return plan;
+}
+
+// A wire at the top of the budget makes every gate that reads it overflow. Greedy pays one
+// bootstrap per such reader; when the full operands of an overflowing gate have more
+// readers still to come than there are operands, refreshing the operands is cheaper and
+// also lowers every later reader.
+BootstrapPlan BootstrapPlanner::Plan(const Circuit &circuit) const {
+    BootstrapPlan plan;
+    std::vector<long long> levels(circuit.gates.size(), 0);
+    std::vector<std::vector<int> > readers(circuit.gates.size());
+    std::vector<size_t> counted(circuit.gates.size(), 0);
+
+    plan.depth = depth;
+    plan.refresh.assign(circuit.gates.size(), false);
+
+    for (size_t i = 0; i < circuit.gates.size(); i++)
+        if (IsComputedGate(circuit, i))
+            for (int j = 0; j < 3; j++)
+                if (circuit.gates[i].input[j] >= 0 && (j == 0 || circuit.gates[i].input[j] != circuit.gates[i].input[j - 1]))
+                    readers[circuit.gates[i].input[j]].push_back(i);
+
+    for (size_t i = 0; i < circuit.gates.size(); i++)
+    {
+        if (!IsComputedGate(circuit, i))
+            continue;
+
+        long long level = PlannedLevel(circuit, levels, i);
+
+        if (level <= depth)
+        {
+            levels[i] = level;
+            continue;
+        }
+
+        const Gate &gate = circuit.gates[i];
+        std::vector<int> full;
+        long long pending = 0;
+        bool lowerable = true;
+
+        for (int j = 0; j < 3; j++)
+        {
+            int operand = gate.input[j];
+
+            if (operand < 0 || levels[operand] != depth || std::find(full.begin(), full.end(), operand) != full.end())
+                continue;
+
+            lowerable &= levels[operand] > 0;
+            full.push_back(operand);
+
+            for (size_t k = 0; k < readers[operand].size(); k++)
+            {
+                size_t reader = readers[operand][k];
+
+                if (reader >= i && counted[reader] != i + 1)
+                {
+                    counted[reader] = i + 1;
+                    pending++;
+                }
+            }
+        }
+
+        if (lowerable && (long long)full.size() < pending)
+        {
+            for (size_t j = 0; j < full.size(); j++)
+            {
+                plan.refresh[full[j]] = true;
+                levels[full[j]] = 0;
+            }
+
+            levels[i] = PlannedLevel(circuit, levels, i);
+        }
+        else
+        {
+            plan.refresh[i] = true;
+            levels[i] = 0;
+        }
+    }
+
+    BootstrapPlan planned = Prune(circuit, plan), greedy = Prune(circuit, Greedy(circuit));
+
+    return planned.GetBootstrapping() <= greedy.GetBootstrapping() ? planned : greedy;
+}
+
+// Drops refreshes one at a time, latest first, whenever the plan stays within budget
+// without them
+BootstrapPlan BootstrapPlanner::Prune(const Circuit &circuit, const BootstrapPlan &plan) const {
+    BootstrapPlan result = plan;
+    std::vector<long long> levels(circuit.gates.size(), 0), trial;
+
+    if (!PlanLevels(circuit, result, levels, 0))
+        return result;
+
+    for (size_t i = circuit.gates.size(); i-- > 0;)
+    {
+        if (!result.refresh[i])
+            continue;
+
+        trial = levels;
+        result.refresh[i] = false;
+
+        if (PlanLevels(circuit, result, trial, i))
+            levels.swap(trial);
+        else
+            result.refresh[i] = true;
+    }
+
+    return result;
+}
@@ -0,0 +1,64 @@
+#ifndef HOMOMORPHIC_ENCRYPTION_BOOTSTRAP_PLANNER_H
+#define HOMOMORPHIC_ENCRYPTION_BOOTSTRAP_PLANNER_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <ostream>
+#include "homomorphicEvaluation.h"
+
+namespace homomorphicEvaluation {
+    // Levelled bit that is bootstrapped only when told to. Gates raise the level like
+    // SimulatedLevelledBit but never refresh on their own; Refresh brings the wire back to
+    // level 0, and a BootstrapPlan decides where that happens.
+    class PlannedLevelledBit {
+    public:
+        bool value;
+        long long level;
+        long long depth;
+        Computation* routine;
+        PlannedLevelledBit() { value = 0; level = 0; depth = 0; routine = NULL; }
+        PlannedLevelledBit(bool n) { value = n; level = 0; depth = 0; routine = NULL; }
+        void Initialize(long long newDepth, Computation& newComputation);
+        void Initialize(bool n, long long newDepth, Computation& newComputation);
+        void Refresh();
+        PlannedLevelledBit operator&(const PlannedLevelledBit& a) const;
+        PlannedLevelledBit operator^(const PlannedLevelledBit& a) const;
+        PlannedLevelledBit operator|(const PlannedLevelledBit& a) const;
+        PlannedLevelledBit operator!() const;
+    };
+
+    // Gates of a circuit whose outputs are bootstrapped under a depth budget. A refreshed
+    // gate is bootstrapped as soon as it is evaluated and all its readers see level 0. As in
+    // SimulatedLevelledBit, a refreshed gate may itself sit one level past the budget,
+    // while every wire that is read or output stays within it.
+    class BootstrapPlan {
+    public:
+        long long depth;
+        std::vector<bool> refresh;
+        BootstrapPlan() { depth = 0; }
+        long long GetBootstrapping() const;
+        bool IsValid(const Circuit& circuit) const;
+        bool Execute(const Circuit& circuit, const std::vector<PlannedLevelledBit>& inputValues, std::vector<PlannedLevelledBit>& outputValues) const;
+        void Write(std::ostream& out) const;
+    };
+
+    // Places the bootstraps of a levelled evaluation over a whole recorded circuit instead of
+    // one gate at a time. Greedy reproduces what SimulatedLevelledBit does; Plan refreshes
+    // wires shared by several overflowing readers once instead of refreshing every reader,
+    // then drops refreshes the budget does not need, and never returns more bootstraps
+    // than Greedy.
+    class BootstrapPlanner {
+    public:
+        long long depth;
+        BootstrapPlanner(long long newDepth) { depth = newDepth; }
+        BootstrapPlan Greedy(const Circuit& circuit) const;
+        BootstrapPlan Plan(const Circuit& circuit) const;
+        BootstrapPlan Prune(const Circuit& circuit, const BootstrapPlan& plan) const;
+    };
+
+    // bootstrapPlanner.cpp includes the planner and the planned levelled bit
+    #include "bootstrapPlanner.cpp"
+};
+
+#endif
@@ -0,0 +1,356 @@
+// Value of a constant gate, or -1 for a computed one
+int ConstantOf(const Circuit &circuit, int id) {
+    if (id < 0 || circuit.gates[id].type != GateType::Constant)
+        return -1;
+
+    return circuit.gates[id].input[0];
+}
+
+// Operand of a NOT gate, or -1 for any other gate
+int NegatedOf(const Circuit &circuit, int id) {
+    if (id < 0 || circuit.gates[id].type != GateType::Not)
+        return -1;
+
+    return circuit.gates[id].input[0];
+}
+
+bool IsBinaryGate(GateType type) {
+    return type != GateType::Input && type != GateType::Constant && type != GateType::Not && type != GateType::Mux;
+}
+
+// Truth table of a two-input gate, bit 2a + b holding the output for inputs a and b
+int GateTable(GateType type) {
+    int table = 0;
+
+    for (int i = 0; i < 4; i++)
+        table |= GateOutput(OperationOf(type), i >> 1, i & 1) << i;
+
+    return table;
+}
+
+// The TFHE gate with a given truth table; every table that depends on both inputs has one
+GateType TableGate(int table) {
+    for (int i = (int)Operation::And; i <= (int)Operation::OrYN; i++)
+        if (GateTable(GateOf((Operation)i)) == table)
+            return GateOf((Operation)i);
+
+    return GateType::Input;
+}
+
+int NegateFirstInput(int table) {
+    return ((table & 3) << 2) | (table >> 2);
+}
+
+int NegateSecondInput(int table) {
+    return ((table & 5) << 1) | ((table >> 1) & 5);
+}
+
+int SwapInputs(int table) {
+    return (table & 9) | ((table & 2) << 1) | ((table & 4) >> 1);
+}
+
+// Gates and outputs that read each gate
+std::vector<int> CountReaders(const Circuit &circuit) {
+    std::vector<int> readers(circuit.gates.size(), 0);
+
+    for (size_t i = 0; i < circuit.gates.size(); i++)
+        if (circuit.gates[i].type != GateType::Input && circuit.gates[i].type != GateType::Constant)
+            for (int j = 0; j < 3; j++)
+                if (circuit.gates[i].input[j] >= 0)
+                    readers[circuit.gates[i].input[j]]++;
+
+    for (size_t i = 0; i < circuit.outputs.size(); i++)
+        readers[circuit.outputs[i]]++;
+
+    return readers;
+}
+
+// Copies inputs and constants in order and hands every other gate, with its operands
+// already renumbered, to rewrite, which adds whatever replaces it and returns its id
+template <class Rewrite>
+Circuit RewriteCircuit(const Circuit &circuit, Rewrite rewrite) {
+    Circuit result;
+    std::vector<int> remap(circuit.gates.size(), -1);
+
+    for (size_t i = 0; i < circuit.gates.size(); i++)
+    {
+        Gate gate = circuit.gates[i];
+
+        if (gate.type == GateType::Input)
+            remap[i] = result.AddInput();
+        else if (gate.type == GateType::Constant)
+            remap[i] = result.AddConstant(gate.input[0]);
+        else
+        {
+            for (int j = 0; j < 3; j++)
+                if (gate.input[j] >= 0)
+                    gate.input[j] = remap[gate.input[j]];
+
+            remap[i] = rewrite(result, gate, i);
+        }
+    }
+
+    for (size_t i = 0; i < circuit.outputs.size(); i++)
+        result.outputs.push_back(remap[circuit.outputs[i]]);
+
+    return result;
+}
+
+// Adds a gate reduced as far as its constant and repeated operands allow. A two-input gate
+// with either is a constant, a copy or a NOT; a MUX with one constant data input is a
+// single AND or OR around the selector, half of its bootstraps.
+int SimplifiedGate(Circuit &circuit, GateType type, int a, int b = -1, int c = -1) {
+    int x = ConstantOf(circuit, a), y = ConstantOf(circuit, b), z = ConstantOf(circuit, c);
+
+    if (IsBinaryGate(type) && (x >= 0 || y >= 0 || a == b))
+    {
+        Operation operation = OperationOf(type);
+
+        if (x >= 0 && y >= 0)
+            return circuit.AddConstant(GateOutput(operation, x, y));
+
+        int wire = x >= 0 ? b : a;
+        bool low = x >= 0 ? GateOutput(operation, x, 0) : (y >= 0 ? GateOutput(operation, 0, y) : GateOutput(operation, 0, 0));
+        bool high = x >= 0 ? GateOutput(operation, x, 1) : (y >= 0 ? GateOutput(operation, 1, y) : GateOutput(operation, 1, 1));
+
+        if (low == high)
+            return circuit.AddConstant(low);
+
+        return high ? wire : SimplifiedGate(circuit, GateType::Not, wire);
+    }
+
+    switch (type)
+    {
+        case GateType::Not:
+            if (x >= 0)
+                return circuit.AddConstant(!x);
+            break;
+        case GateType::Mux:
+            if (x >= 0)
+                return x ? b : c;
+            if (b == c)
+                return b;
+            if (y >= 0 && z >= 0)
+                return y ? a : SimplifiedGate(circuit, GateType::Not, a);
+            if (y == 0)
+                return SimplifiedGate(circuit, GateType::And, SimplifiedGate(circuit, GateType::Not, a), c);
+            if (y == 1 || a == b)
+                return SimplifiedGate(circuit, GateType::Or, a, c);
+            if (z == 0 || a == c)
+                return SimplifiedGate(circuit, GateType::And, a, b);
+            if (z == 1)
+                return SimplifiedGate(circuit, GateType::Or, SimplifiedGate(circuit, GateType::Not, a), b);
+            break;
+        default:
+            break;
+    }
+
+    return circuit.AddGate(type, a, b, c);
+}
+
+Circuit CircuitOptimizer::PropagateConstants(const Circuit &circuit) {
+    Circuit result = RewriteCircuit(circuit, [](Circuit &rewritten, const Gate &gate, int) {
+        return SimplifiedGate(rewritten, gate.type, gate.input[0], gate.input[1], gate.input[2]);
+    });
+
+    Report("constant-propagation", circuit, result);
+    return result;
+}
+
+// Two-input gates are keyed with their operands in order, swapping the gate for the one
+// with its inputs exchanged, so that a & b and b & a or ANDNY(a, b) and ANDYN(b, a) meet
+Circuit CircuitOptimizer::EliminateCommonSubexpressions(const Circuit &circuit) {
+    std::map<std::array<int, 4>, int> seen;
+
+    Circuit result = RewriteCircuit(circuit, [&seen](Circuit &rewritten, const Gate &gate, int) {
+        std::array<int, 4> key = {{(int)gate.type, gate.input[0], gate.input[1], gate.input[2]}};
+
+        if (IsBinaryGate(gate.type) && key[1] > key[2])
+        {
+            key[0] = (int)TableGate(SwapInputs(GateTable(gate.type)));
+            std::swap(key[1], key[2]);
+        }
+
+        std::map<std::array<int, 4>, int>::iterator found = seen.find(key);
+
+        if (found != seen.end())
+            return found->second;
+
+        return seen[key] = rewritten.AddGate(gate.type, gate.input[0], gate.input[1], gate.input[2]);
+    });
+
+    Report("common-subexpressions", circuit, result);
+    return result;
+}
+
+// Inputs are kept even when unused, so the optimized circuit takes the same input vector
+Circuit CircuitOptimizer::EliminateDeadGates(const Circuit &circuit) {
+    std::vector<bool> live(circuit.gates.size(), false);
+    std::vector<int> remap(circuit.gates.size(), -1);
+    Circuit result;
+
+    for (size_t i = 0; i < circuit.outputs.size(); i++)
+        live[circuit.outputs[i]] = true;
+
+    for (int i = circuit.gates.size() - 1; i >= 0; i--)
+    {
+        const Gate &gate = circuit.gates[i];
+
+        if (live[i] && gate.type != GateType::Input && gate.type != GateType::Constant)
+            for (int j = 0; j < 3; j++)
+                if (gate.input[j] >= 0)
+                    live[gate.input[j]] = true;
+    }
+
+    for (size_t i = 0; i < circuit.gates.size(); i++)
+    {
+        const Gate &gate = circuit.gates[i];
+
+        if (gate.type == GateType::Input)
+            remap[i] = result.AddInput();
+        else if (!live[i])
+            continue;
+        else if (gate.type == GateType::Constant)
+            remap[i] = result.AddConstant(gate.input[0]);
+        else
+            remap[i] = result.AddGate(gate.type, gate.input[0] >= 0 ? remap[gate.input[0]] : -1,
+                gate.input[1] >= 0 ? remap[gate.input[1]] : -1, gate.input[2] >= 0 ? remap[gate.input[2]] : -1);
+    }
+
+    for (size_t i = 0; i < circuit.outputs.size(); i++)
+        result.outputs.push_back(remap[circuit.outputs[i]]);
+
+    Report("dead-gates", circuit, result);
+    return result;
+}
+
+// Cancels double negations and moves NOTs through the gates that absorb them: XOR of two
+// negations, a negated MUX selector, and De Morgan for AND and OR. A NOT is only moved out
+// when nothing else reads it, so it dies instead of being duplicated; pushed outwards it
+// can meet and cancel another NOT on a later round.
+Circuit CircuitOptimizer::AbsorbNots(const Circuit &circuit) {
+    std::vector<int> readers = CountReaders(circuit);
+
+    Circuit result = RewriteCircuit(circuit, [&circuit, &readers](Circuit &rewritten, const Gate &gate, int id) {
+        const Gate &original = circuit.gates[id];
+        int x = NegatedOf(rewritten, gate.input[0]), y = NegatedOf(rewritten, gate.input[1]), z = NegatedOf(rewritten, gate.input[2]);
+        bool movable = (x >= 0 && readers[original.input[0]] == 1) && (y >= 0 && readers[original.input[1]] == 1);
+
+        switch (gate.type)
+        {
+            case GateType::Not:
+                if (x >= 0)
+                    return x;
+                break;
+            case GateType::Xor:
+                if (x >= 0 && y >= 0)
+                    return rewritten.AddGate(GateType::Xor, x, y);
+                if (x >= 0 && readers[original.input[0]] == 1)
+                    return rewritten.AddGate(GateType::Not, rewritten.AddGate(GateType::Xor, x, gate.input[1]));
+                if (y >= 0 && readers[original.input[1]] == 1)
+                    return rewritten.AddGate(GateType::Not, rewritten.AddGate(GateType::Xor, gate.input[0], y));
+                break;
+            case GateType::And:
+                if (movable)
+                    return rewritten.AddGate(GateType::Not, rewritten.AddGate(GateType::Or, x, y));
+                break;
+            case GateType::Or:
+                if (movable)
+                    return rewritten.AddGate(GateType::Not, rewritten.AddGate(GateType::And, x, y));
+                break;
+            case GateType::Mux:
+                if (x >= 0)
+                    return rewritten.AddGate(GateType::Mux, x, gate.input[2], gate.input[1]);
+                if (y >= 0 && z >= 0 && readers[original.input[1]] == 1 && readers[original.input[2]] == 1)
+                    return rewritten.AddGate(GateType::Not, rewritten.AddGate(GateType::Mux, gate.input[0], y, z));
+                break;
+            default:
+                break;
+        }
+
+        return rewritten.AddGate(gate.type, gate.input[0], gate.input[1], gate.input[2]);
+    });
+
+    Report("not-absorption", circuit, result);
+    return result;
+}
+
+// Technology mapping onto TFHE's gate library: a NOT in front of a two-input gate becomes
+// the variant with that input inverted, and a NOT after one becomes its complement. The
+// negated inputs are always absorbed, since the NOT dies once no reader is left; a gate
+// is only complemented when the NOT is its single reader, so nothing is bootstrapped twice.
+Circuit CircuitOptimizer::MapGates(const Circuit &circuit) {
+    std::vector<int> readers = CountReaders(circuit);
+
+    Circuit result = RewriteCircuit(circuit, [&circuit, &readers](Circuit &rewritten, const Gate &gate, int id) {
+        if (gate.type == GateType::Not)
+        {
+            const Gate operand = rewritten.gates[gate.input[0]];
+
+            if (IsBinaryGate(operand.type) && readers[circuit.gates[id].input[0]] == 1)
+                return rewritten.AddGate(TableGate(~GateTable(operand.type) & 15), operand.input[0], operand.input[1]);
+        }
+        else if (IsBinaryGate(gate.type))
+        {
+            int table = GateTable(gate.type), a = gate.input[0], b = gate.input[1];
+            int x = NegatedOf(rewritten, a), y = NegatedOf(rewritten, b);
+
+            if (x >= 0)
+            {
+                table = NegateFirstInput(table);
+                a = x;
+            }
+            if (y >= 0)
+            {
+                table = NegateSecondInput(table);
+                b = y;
+            }
+
+            return rewritten.AddGate(TableGate(table), a, b);
+        }
+
+        return rewritten.AddGate(gate.type, gate.input[0], gate.input[1], gate.input[2]);
+    });
+
+    Report("technology-mapping", circuit, result);
+    return result;
+}
+
+// Runs the passes in turn until a round leaves the circuit as it was. Constant propagation,
+// NOT absorption and mapping expose duplicates and leave dead gates behind, so they go first.
+Circuit CircuitOptimizer::Optimize(const Circuit &circuit, int maximumRounds) {
+    Circuit current = circuit;
+
+    for (int round = 0; round < maximumRounds; round++)
+    {
+        long long gates = current.GetGateCount(), bootstraps = current.GetBootstrapping();
+
+        current = PropagateConstants(current);
+        current = AbsorbNots(current);
+        current = MapGates(current);
+        current = EliminateCommonSubexpressions(current);
+        current = EliminateDeadGates(current);
+
+        if (current.GetGateCount() == gates && current.GetBootstrapping() == bootstraps)
+            break;
+    }
+
+    return current;
+}
+
+void CircuitOptimizer::Report(const std::string &name, const Circuit &before, const Circuit &after) {
+    PassReport report = {name, before.GetGateCount(), after.GetGateCount(), before.GetBootstrapping(),
+        after.GetBootstrapping(), before.GetDepth(), after.GetDepth()};
+
+    reports.push_back(report);
+}
+
+// One row per pass run, in the order they ran
+void CircuitOptimizer::WriteReport(std::ostream &out) const {
+    out << "pass,gates before,gates after,bootstraps before,bootstraps after,depth before,depth after" << std::endl;
+
+    for (size_t i = 0; i < reports.size(); i++)
+        out << reports[i].name << "," << reports[i].gatesBefore << "," << reports[i].gatesAfter << ","
+            << reports[i].bootstrapsBefore << "," << reports[i].bootstrapsAfter << ","
+            << reports[i].depthBefore << "," << reports[i].depthAfter << std::endl;
+}
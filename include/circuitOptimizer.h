@@ -0,0 +1,42 @@
+#ifndef HOMOMORPHIC_ENCRYPTION_CIRCUIT_OPTIMIZER_H
+#define HOMOMORPHIC_ENCRYPTION_CIRCUIT_OPTIMIZER_H
+
+#include <map>
+#include <array>
+#include <string>
+#include <vector>
+#include <ostream>
+#include "homomorphicEvaluation.h"
+
+namespace homomorphicEvaluation {
+    // Size of a circuit before and after one pass
+    struct PassReport {
+        std::string name;
+        long long gatesBefore, gatesAfter;
+        long long bootstrapsBefore, bootstrapsAfter;
+        long long depthBefore, depthAfter;
+    };
+
+    // Rewrites recorded circuits into equivalent ones with fewer bootstrapped gates. Every
+    // pass returns a new circuit with the inputs in their original order and the same
+    // outputs, so the result runs wherever the original did: Evaluate, Execute on any bit
+    // type, or a ParallelExecutor. Each pass appends a report of what it changed.
+    class CircuitOptimizer {
+    public:
+        std::vector<PassReport> reports;
+        Circuit Optimize(const Circuit& circuit, int maximumRounds = 8);
+        Circuit PropagateConstants(const Circuit& circuit);
+        Circuit EliminateCommonSubexpressions(const Circuit& circuit);
+        Circuit EliminateDeadGates(const Circuit& circuit);
+        Circuit AbsorbNots(const Circuit& circuit);
+        Circuit MapGates(const Circuit& circuit);
+        void WriteReport(std::ostream& out) const;
+    private:
+        void Report(const std::string& name, const Circuit& before, const Circuit& after);
+    };
+
+    // circuitOptimizer.cpp includes the definitions of the optimizer passes
+    #include "circuitOptimizer.cpp"
+};
+
+#endif
@@ -0,0 +1,263 @@
+const char columnMagic[8] = {'F', 'H', 'E', 'C', 'O', 'L', 0, 0};
+const uint32_t columnVersion = 1;
+const uint64_t columnAlignment = 4096;
+
+// One bit is stored as its body and variance followed by the n mask coefficients
+struct ColumnBitHead {
+    int32_t b;
+    int32_t unused;
+    double variance;
+};
+
+uint64_t ColumnBitBytes(int dimension) {
+    return (sizeof(ColumnBitHead) + dimension * sizeof(Torus32) + 7) / 8 * 8;
+}
+
+template <int N>
+EncryptedColumnWriter<N>::EncryptedColumnWriter() {
+    file = NULL;
+    context = NULL;
+}
+
+template <int N>
+EncryptedColumnWriter<N>::~EncryptedColumnWriter() {
+    Close();
+}
+
+template <int N>
+bool EncryptedColumnWriter<N>::Open(const std::string &path, FheContext &newContext, int chunkRecords) {
+    Close();
+
+    if (newContext.params == NULL || chunkRecords <= 0)
+        return false;
+
+    file = fopen(path.c_str(), "wb");
+
+    if (file == NULL)
+        return false;
+
+    context = &newContext;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, columnMagic, sizeof(header.magic));
+    header.version = columnVersion;
+    header.width = N;
+    header.dimension = context->params->in_out_params->n;
+    header.chunkRecords = chunkRecords;
+    header.recordBytes = N * ColumnBitBytes(header.dimension);
+    header.chunkBytes = (chunkRecords * header.recordBytes + columnAlignment - 1) / columnAlignment * columnAlignment;
+    header.dataOffset = columnAlignment;
+
+    fwrite(&header, sizeof(header), 1, file);
+    fseek(file, header.dataOffset, SEEK_SET);
+
+    return !ferror(file);
+}
+
+// Public constant bits have no ciphertext and are written as trivial encryptions
+template <int N>
+bool EncryptedColumnWriter<N>::Append(const GenericInt<N, RealGateBootstrappedBit> &a) {
+    if (file == NULL)
+        return false;
+
+    uint64_t chunk = header.recordCount / header.chunkRecords;
+    uint64_t offset = header.dataOffset + chunk * header.chunkBytes + (header.recordCount % header.chunkRecords) * header.recordBytes;
+    const char padding[8] = {0};
+    uint64_t paddingBytes = ColumnBitBytes(header.dimension) - sizeof(ColumnBitHead) - header.dimension * sizeof(Torus32);
+    RealGateBootstrappedBit constant(*context, uninitialized);
+
+    fseek(file, offset, SEEK_SET);
+
+    for (int i = 0; i < N; i++)
+    {
+        const LweSample *sample = a.encValue[i].value;
+
+        if (sample == NULL)
+        {
+            bootsCONSTANT(constant.value, a.encValue[i].plain, context->cloudKey);
+            sample = constant.value;
+        }
+
+        ColumnBitHead head = {sample->b, 0, sample->current_variance};
+
+        fwrite(&head, sizeof(head), 1, file);
+        fwrite(sample->a, sizeof(Torus32), header.dimension, file);
+        fwrite(padding, 1, paddingBytes, file);
+    }
+
+    header.recordCount++;
+    return !ferror(file);
+}
+
+// The record count goes into the header last, so an interrupted writer leaves an empty column
+template <int N>
+bool EncryptedColumnWriter<N>::Close() {
+    if (file == NULL)
+        return false;
+
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+
+    bool written = !ferror(file);
+    bool closed = fclose(file) == 0;
+
+    file = NULL;
+    return written && closed;
+}
+
+template <int N>
+EncryptedColumnReader<N>::EncryptedColumnReader() {
+    mapping = NULL;
+    mappingSize = 0;
+    context = NULL;
+    memset(&header, 0, sizeof(header));
+}
+
+template <int N>
+EncryptedColumnReader<N>::~EncryptedColumnReader() {
+    Close();
+}
+
+template <int N>
+bool EncryptedColumnReader<N>::Open(const std::string &path, FheContext &newContext) {
+    Close();
+
+    if (newContext.params == NULL)
+        return false;
+
+    int descriptor = open(path.c_str(), O_RDONLY);
+    struct stat status;
+
+    if (descriptor < 0)
+        return false;
+
+    if (fstat(descriptor, &status) != 0 || (size_t)status.st_size < sizeof(ColumnHeader))
+    {
+        close(descriptor);
+        return false;
+    }
+
+    void *address = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+
+    if (address == MAP_FAILED)
+        return false;
+
+    mapping = (char*)address;
+    mappingSize = status.st_size;
+    context = &newContext;
+    memcpy(&header, mapping, sizeof(header));
+
+    uint64_t chunkRecords = std::max(header.chunkRecords, 1);
+    uint64_t chunks = header.recordCount / chunkRecords + (header.recordCount % chunkRecords != 0);
+
+    // Records have to match the width asked for and the ciphertexts of the context, every
+    // chunk has to hold its records and start on a page boundary, and the size of the data
+    // must not overflow
+    bool valid = memcmp(header.magic, columnMagic, sizeof(header.magic)) == 0 && header.version == columnVersion
+        && header.width == N && header.dimension == context->params->in_out_params->n && header.chunkRecords > 0
+        && header.recordBytes == N * ColumnBitBytes(header.dimension)
+        && header.chunkBytes / chunkRecords >= header.recordBytes
+        && header.dataOffset % columnAlignment == 0 && header.chunkBytes % columnAlignment == 0
+        && header.dataOffset >= sizeof(ColumnHeader)
+        && chunks <= (UINT64_MAX - header.dataOffset) / header.chunkBytes;
+
+    // The data ends with the records of the last chunk, which may be short
+    if (valid && chunks > 0)
+    {
+        uint64_t lastRecords = header.recordCount - (chunks - 1) * chunkRecords;
+
+        valid = header.dataOffset + (chunks - 1) * header.chunkBytes + lastRecords * header.recordBytes <= mappingSize;
+    }
+
+    if (!valid)
+    {
+        Close();
+        return false;
+    }
+
+    chunkSamples.assign(chunks, (LweSample*)NULL);
+    return true;
+}
+
+template <int N>
+void EncryptedColumnReader<N>::Close() {
+    for (size_t i = 0; i < chunkSamples.size(); i++)
+        free(chunkSamples[i]);
+
+    chunkSamples.clear();
+
+    if (mapping != NULL)
+        munmap(mapping, mappingSize);
+
+    mapping = NULL;
+    mappingSize = 0;
+    header.recordCount = 0;
+}
+
+template <int N>
+uint64_t EncryptedColumnReader<N>::GetCount() const {
+    return header.recordCount;
+}
+
+template <int N>
+uint64_t EncryptedColumnReader<N>::GetOffset(uint64_t index) const {
+    uint64_t chunk = index / std::max(header.chunkRecords, 1);
+
+    return header.dataOffset + chunk * header.chunkBytes + (index % std::max(header.chunkRecords, 1)) * header.recordBytes;
+}
+
+// Sample headers are built a chunk at a time on first touch and point into the mapping
+template <int N>
+GenericInt<N, RealGateBootstrappedBit> EncryptedColumnReader<N>::Read(uint64_t index) {
+    GenericInt<N, RealGateBootstrappedBit> result;
+    uint64_t chunk = index / header.chunkRecords;
+
+    if (index >= header.recordCount)
+        return result;
+
+    if (chunkSamples[chunk] == NULL)
+    {
+        uint64_t first = chunk * header.chunkRecords;
+        uint64_t count = std::min((uint64_t)header.chunkRecords, header.recordCount - first);
+        LweSample *samples = (LweSample*)malloc(count * N * sizeof(LweSample));
+
+        for (uint64_t i = 0; i < count; i++)
+        {
+            char *record = mapping + GetOffset(first + i);
+
+            for (int j = 0; j < N; j++)
+            {
+                char *bit = record + j * ColumnBitBytes(header.dimension);
+                const ColumnBitHead *head = (const ColumnBitHead*)bit;
+                LweSample &sample = samples[i * N + j];
+
+                sample.a = (Torus32*)(bit + sizeof(ColumnBitHead));
+                sample.b = head->b;
+                sample.current_variance = head->variance;
+            }
+        }
+
+        chunkSamples[chunk] = samples;
+    }
+
+    LweSample *samples = chunkSamples[chunk] + (index % header.chunkRecords) * N;
+
+    for (int i = 0; i < N; i++)
+        result.encValue[i] = RealGateBootstrappedBit(*context, samples + i);
+
+    return result;
+}
+
+// Bits read from the chunk must be gone before it is released
+template <int N>
+void EncryptedColumnReader<N>::ReleaseChunk(uint64_t chunk) {
+    if (chunk >= chunkSamples.size())
+        return;
+
+    free(chunkSamples[chunk]);
+    chunkSamples[chunk] = NULL;
+
+    uint64_t offset = header.dataOffset + chunk * header.chunkBytes;
+
+    madvise(mapping + offset, std::min((uint64_t)header.chunkBytes, mappingSize - offset), MADV_DONTNEED);
+}
@@ -0,0 +1,69 @@
+#ifndef HOMOMORPHIC_ENCRYPTION_ENCRYPTED_COLUMN_H
+#define HOMOMORPHIC_ENCRYPTION_ENCRYPTED_COLUMN_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "homomorphicEvaluation.h"
+
+namespace homomorphicEvaluation {
+    // Start of an encrypted column file. Records are N bit ciphertexts each, grouped into
+    // chunks that start on a page boundary, so any record sits at a computable offset and
+    // a chunk can be paged in or dropped on its own.
+    struct ColumnHeader {
+        char magic[8];
+        uint32_t version;
+        int32_t width, dimension, chunkRecords;
+        uint64_t recordCount, recordBytes, chunkBytes, dataOffset;
+    };
+
+    // Appends GenericInt records to a column file one at a time; nothing is buffered beyond
+    // stdio, so a column of any length is written in constant memory
+    template <int N>
+    class EncryptedColumnWriter {
+    public:
+        EncryptedColumnWriter();
+        ~EncryptedColumnWriter();
+        bool Open(const std::string& path, FheContext& newContext, int chunkRecords = 1024);
+        bool Append(const GenericInt<N, RealGateBootstrappedBit>& a);
+        bool Close();
+    private:
+        FILE* file;
+        FheContext* context;
+        ColumnHeader header;
+    };
+
+    // Maps a column file read-only. A record comes back as borrowed bits whose masks stay
+    // in the mapping, so reading costs no copies and the page cache holds only the chunks
+    // in use; ReleaseChunk hands a finished chunk back to the kernel.
+    template <int N>
+    class EncryptedColumnReader {
+    public:
+        EncryptedColumnReader();
+        ~EncryptedColumnReader();
+        bool Open(const std::string& path, FheContext& newContext);
+        void Close();
+        uint64_t GetCount() const;
+        GenericInt<N, RealGateBootstrappedBit> Read(uint64_t index);
+        void ReleaseChunk(uint64_t chunk);
+    private:
+        char* mapping;
+        size_t mappingSize;
+        FheContext* context;
+        ColumnHeader header;
+        std::vector<LweSample*> chunkSamples;
+        uint64_t GetOffset(uint64_t index) const;
+    };
+
+    // encryptedColumn.cpp includes the definitions of the column reader and writer
+    #include "encryptedColumn.cpp"
+};
+
+#endif
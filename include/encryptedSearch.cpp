@@ -0,0 +1,169 @@
+// Pairs neighbours level by level until one bit is left; each level is written over the
+// front of the copy, so a std::array of bits is reduced without allocating
+template <class Bits>
+typename Bits::value_type ReduceBits(Bits bits, bool conjunction) {
+    size_t n = bits.size();
+
+    if (n == 0)
+        return Bits::value_type::Constant(conjunction);
+
+    while (n > 1)
+    {
+        for (size_t i = 0; i < n; i += 2)
+            bits[i / 2] = i + 1 == n ? bits[i] : (conjunction ? FoldedAnd(bits[i], bits[i + 1]) : FoldedOr(bits[i], bits[i + 1]));
+
+        n = (n + 1) / 2;
+    }
+
+    return bits[0];
+}
+
+template <class BoolType>
+std::vector<FoldedBit<BoolType> > FoldBits(const std::vector<BoolType> &bits) {
+    std::vector<FoldedBit<BoolType> > folded;
+
+    for (size_t i = 0; i < bits.size(); i++)
+        folded.push_back(FoldedBit<BoolType>::Wire(bits[i]));
+
+    return folded;
+}
+
+template <class BoolType>
+BoolType orTree(const std::vector<BoolType> &bits) {
+    return FoldedValue(ReduceBits(FoldBits(bits), false));
+}
+
+template <class BoolType>
+BoolType andTree(const std::vector<BoolType> &bits) {
+    return FoldedValue(ReduceBits(FoldBits(bits), true));
+}
+
+template <int N, class BoolType>
+std::vector<BoolType> equalAll(const GenericInt<N, BoolType> &key, const std::vector<GenericInt<N, BoolType> > &records) {
+    std::array<FoldedBit<BoolType>, N> x = key.GetFoldedBits();
+    std::vector<BoolType> result;
+
+    for (size_t j = 0; j < records.size(); j++)
+    {
+        std::array<FoldedBit<BoolType>, N> y = records[j].GetFoldedBits(), same;
+
+        for (int i = 0; i < N; i++)
+            same[i] = FoldedNot(FoldedXor(x[i], y[i]));
+
+        result.push_back(FoldedValue(ReduceBits(same, true)));
+    }
+
+    return result;
+}
+
+typedef std::map<std::pair<std::pair<int, int>, unsigned long long>, int> MatchIndex;
+
+// Whether bits [low, high) of the key spell out the same bits of value, as the AND of a
+// balanced tree of literals; every range and value is built once and then looked up
+template <class Bits, class BoolType>
+FoldedBit<BoolType> MatchBits(const Bits &key, int low, int high, unsigned long long value, MatchIndex &index, std::vector<FoldedBit<BoolType> > &matches) {
+    if (high - low == 1)
+        return (value >> low) & 1 ? key[low] : FoldedNot(key[low]);
+
+    unsigned long long part = (value >> low) & (high - low >= 64 ? ~0ULL : (1ULL << (high - low)) - 1);
+    std::pair<std::pair<int, int>, unsigned long long> range(std::make_pair(low, high), part);
+    MatchIndex::iterator found = index.find(range);
+
+    if (found != index.end())
+        return matches[found->second];
+
+    int middle = (low + high) / 2;
+    FoldedBit<BoolType> match = FoldedAnd(MatchBits(key, low, middle, value, index, matches), MatchBits(key, middle, high, value, index, matches));
+
+    index[range] = matches.size();
+    matches.push_back(match);
+
+    return match;
+}
+
+template <int N, class BoolType>
+std::vector<BoolType> equalAll(const GenericInt<N, BoolType> &key, const std::vector<unsigned long long> &values) {
+    std::array<FoldedBit<BoolType>, N> x = key.GetFoldedBits();
+    std::vector<FoldedBit<BoolType> > matches;
+    std::vector<BoolType> result;
+    MatchIndex index;
+
+    for (size_t j = 0; j < values.size(); j++)
+    {
+        if (N < 64 && (values[j] >> N) != 0)
+            result.push_back(BoolType(0));
+        else
+            result.push_back(FoldedValue(MatchBits(x, 0, N, values[j], index, matches)));
+    }
+
+    return result;
+}
+
+template <int N, class BoolType>
+BoolType contains(const GenericInt<N, BoolType> &key, const std::vector<GenericInt<N, BoolType> > &records) {
+    return orTree(equalAll(key, records));
+}
+
+template <int N, class BoolType>
+BoolType contains(const GenericInt<N, BoolType> &key, const std::vector<unsigned long long> &values) {
+    return orTree(equalAll(key, values));
+}
+
+// Entry picked by the selector bits from entries of N folded bits each
+template <int N, class BoolType, class Bits>
+std::array<FoldedBit<BoolType>, N> LookupBits(std::vector<std::array<FoldedBit<BoolType>, N> > entries, const Bits &selector) {
+    int bit = 0;
+
+    if (entries.empty())
+        return ConstantBits<N, BoolType>(0);
+
+    // Bit b of the index picks between neighbours; an entry without a neighbour is kept
+    // only when the bit is 0
+    for (; bit < (int)selector.size() && entries.size() > 1; bit++)
+    {
+        std::vector<std::array<FoldedBit<BoolType>, N> > next((entries.size() + 1) / 2);
+
+        for (size_t j = 0; j < next.size(); j++)
+            for (int i = 0; i < N; i++)
+                next[j][i] = 2 * j + 1 < entries.size()
+                    ? FoldedMux(selector[bit], entries[2 * j + 1][i], entries[2 * j][i])
+                    : FoldedAnd(FoldedNot(selector[bit]), entries[2 * j][i]);
+
+        entries.swap(next);
+    }
+
+    // With more entries than the index can address, the first group is the reachable one
+    std::array<FoldedBit<BoolType>, N> result = entries[0];
+
+    // Any higher bit set means the index is out of range
+    if (bit < (int)selector.size())
+    {
+        FoldedBit<BoolType> outside = ReduceBits(std::vector<FoldedBit<BoolType> >(selector.begin() + bit, selector.end()), false);
+
+        for (int i = 0; i < N; i++)
+            result[i] = FoldedAnd(FoldedNot(outside), result[i]);
+    }
+
+    return result;
+}
+
+template <int N, int M, class BoolType>
+GenericInt<N, BoolType> lookup(const std::vector<GenericInt<N, BoolType> > &table, const GenericInt<M, BoolType> &index) {
+    std::vector<std::array<FoldedBit<BoolType>, N> > entries;
+
+    for (size_t j = 0; j < table.size(); j++)
+        entries.push_back(table[j].GetFoldedBits());
+
+    return GenericInt<N, BoolType>().FromFoldedBits(LookupBits<N>(entries, index.GetFoldedBits()));
+}
+
+template <int N, int M, class BoolType>
+GenericInt<N, BoolType> lookup(const std::vector<unsigned long long> &table, const GenericInt<M, BoolType> &index) {
+    std::vector<std::array<FoldedBit<BoolType>, N> > entries(table.size());
+
+    for (size_t j = 0; j < table.size(); j++)
+        for (int i = 0; i < N; i++)
+            entries[j][i] = FoldedBit<BoolType>::Constant(i < 64 && ((table[j] >> i) & 1));
+
+    return GenericInt<N, BoolType>().FromFoldedBits(LookupBits<N>(entries, index.GetFoldedBits()));
+}
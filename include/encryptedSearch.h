@@ -0,0 +1,34 @@
+#ifndef HOMOMORPHIC_ENCRYPTION_ENCRYPTED_SEARCH_H
+#define HOMOMORPHIC_ENCRYPTION_ENCRYPTED_SEARCH_H
+
+#include <map>
+#include <utility>
+#include <vector>
+#include "homomorphicEvaluation.h"
+
+namespace homomorphicEvaluation {
+    // OR and AND of any number of bits as balanced trees, so that the depth grows with the
+    // logarithm of the number of bits; constant bits fold away
+    template <class BoolType> BoolType orTree(const std::vector<BoolType>& bits);
+    template <class BoolType> BoolType andTree(const std::vector<BoolType>& bits);
+
+    // Equality of one key against every record. Against public values the key's literals are
+    // shared: matches of the same value on the same bit range are built once, whichever
+    // record needs them.
+    template <int N, class BoolType> std::vector<BoolType> equalAll(const GenericInt<N, BoolType>& key, const std::vector<GenericInt<N, BoolType> >& records);
+    template <int N, class BoolType> std::vector<BoolType> equalAll(const GenericInt<N, BoolType>& key, const std::vector<unsigned long long>& values);
+    template <int N, class BoolType> BoolType contains(const GenericInt<N, BoolType>& key, const std::vector<GenericInt<N, BoolType> >& records);
+    template <int N, class BoolType> BoolType contains(const GenericInt<N, BoolType>& key, const std::vector<unsigned long long>& values);
+
+    // table[index] for an encrypted index through a tree of MUXes, one level per index bit;
+    // an index past the end of the table gives 0
+    template <int N, int M, class BoolType> GenericInt<N, BoolType> lookup(const std::vector<GenericInt<N, BoolType> >& table, const GenericInt<M, BoolType>& index);
+    // The same over a public table of N-bit values, whose first level folds into literals
+    // of the lowest index bit
+    template <int N, int M, class BoolType> GenericInt<N, BoolType> lookup(const std::vector<unsigned long long>& table, const GenericInt<M, BoolType>& index);
+
+    // encryptedSearch.cpp includes the search and lookup kernels
+    #include "encryptedSearch.cpp"
+};
+
+#endif
@@ -1,584 +1,2385 @@
+const char *OperationName(Operation operation) {
+    static const char *names[operationKinds] = {"and", "or", "xor", "xnor", "nand", "nor", "andny", "andyn", "orny", "oryn",
+        "mux", "not", "copy", "encrypt", "decrypt"};
+
+    return names[(int)operation];
+}
+
+bool IsCounted(Operation operation) {
+    return operation != Operation::Copy && operation != Operation::Decrypt;
+}
+
+// Truth tables of the two-input gates, bit 2a + b holding the output for inputs a and b
+bool GateOutput(Operation operation, bool a, bool b) {
+    static const int tables[] = {8, 14, 6, 9, 7, 1, 2, 4, 11, 13};
+
+    return (tables[(int)operation] >> (2 * a + b)) & 1;
+}
+
+Operation OperationOf(GateType type) {
+    switch (type)
+    {
+        case GateType::And: return Operation::And;
+        case GateType::Xor: return Operation::Xor;
+        case GateType::Or: return Operation::Or;
+        case GateType::Not: return Operation::Not;
+        case GateType::Mux: return Operation::Mux;
+        case GateType::Xnor: return Operation::Xnor;
+        case GateType::Nand: return Operation::Nand;
+        case GateType::Nor: return Operation::Nor;
+        case GateType::AndNY: return Operation::AndNY;
+        case GateType::AndYN: return Operation::AndYN;
+        case GateType::OrNY: return Operation::OrNY;
+        case GateType::OrYN: return Operation::OrYN;
+        default: return Operation::Copy;
+    }
+}
+
+GateType GateOf(Operation operation) {
+    switch (operation)
+    {
+        case Operation::And: return GateType::And;
+        case Operation::Xor: return GateType::Xor;
+        case Operation::Or: return GateType::Or;
+        case Operation::Not: return GateType::Not;
+        case Operation::Mux: return GateType::Mux;
+        case Operation::Xnor: return GateType::Xnor;
+        case Operation::Nand: return GateType::Nand;
+        case Operation::Nor: return GateType::Nor;
+        case Operation::AndNY: return GateType::AndNY;
+        case Operation::AndYN: return GateType::AndYN;
+        case Operation::OrNY: return GateType::OrNY;
+        case Operation::OrYN: return GateType::OrYN;
+        default: return GateType::Input;
+    }
+}
+
+// Binary gate of TFHE's library for a gate operation
+void BootsGate(Operation operation, LweSample *result, const LweSample *a, const LweSample *b, const TFheGateBootstrappingCloudKeySet *cloud) {
+    switch (operation)
+    {
+        case Operation::And: bootsAND(result, a, b, cloud); break;
+        case Operation::Or: bootsOR(result, a, b, cloud); break;
+        case Operation::Xor: bootsXOR(result, a, b, cloud); break;
+        case Operation::Xnor: bootsXNOR(result, a, b, cloud); break;
+        case Operation::Nand: bootsNAND(result, a, b, cloud); break;
+        case Operation::Nor: bootsNOR(result, a, b, cloud); break;
+        case Operation::AndNY: bootsANDNY(result, a, b, cloud); break;
+        case Operation::AndYN: bootsANDYN(result, a, b, cloud); break;
+        case Operation::OrNY: bootsORNY(result, a, b, cloud); break;
+        case Operation::OrYN: bootsORYN(result, a, b, cloud); break;
+        default: break;
+    }
+}
+
+// Every bootstrapped two-input gate costs one bootstrap, everything else is free until set
+CostModel::CostModel(const std::string &newName, double newSecondsPerBootstrap) : name(newName) {
+    secondsPerBootstrap = newSecondsPerBootstrap;
+
+    for (int i = 0; i < operationKinds; i++)
+    {
+        bootstraps[i] = 0;
+        seconds[i] = 0;
+    }
+
+    for (int i = (int)Operation::And; i <= (int)Operation::OrYN; i++)
+        SetBootstraps((Operation)i, 1);
+}
+
+void CostModel::SetBootstraps(Operation operation, double n) {
+    bootstraps[(int)operation] = n;
+    seconds[(int)operation] = n * secondsPerBootstrap;
+}
+
+// TFHE gate bootstrapping as measured in testMean.txt; MUX is priced as two bootstraps
+CostModel CostModel::TfheGate() {
+    CostModel model("tfhe-gate", 0.043380846);
+
+    model.SetBootstraps(Operation::Mux, 2);
+
+    return model;
+}
+
+// FHEW bootstraps every gate like TFHE but has no native MUX, so it is built from
+// AND, AND and OR around a free NOT; the time is the published estimate of half a second
+CostModel CostModel::Fhew() {
+    CostModel model("fhew", 0.5);
+
+    model.SetBootstraps(Operation::Mux, 3);
+
+    return model;
+}
+
+// Linear gates are free, so MUX becomes c ^ (a & (b ^ c)) with a single bootstrap
+CostModel CostModel::FreeXor() {
+    CostModel model("free-xor", 0.043380846);
+
+    model.SetBootstraps(Operation::Mux, 1);
+    model.SetBootstraps(Operation::Xor, 0);
+    model.SetBootstraps(Operation::Xnor, 0);
+
+    return model;
+}
+
+// Reads the output of benchmarks/Calibration.cpp, one "operation threads mean stddev p50
+// p90 p99 throughput" row per line. An operation costs its mean latency measured while
+// the given number of threads ran at once, so GetMakespan spreads those latencies over
+// the cores itself; the throughput is only for reading. Fails, leaving model as it was,
+// unless every operation has a row at that thread count.
+bool CostModel::Calibrated(std::istream &in, int threads, CostModel &model) {
+    CostModel calibrated = TfheGate();
+    bool measured[operationKinds] = {};
+    std::string line;
+
+    calibrated.name = "calibrated-" + std::to_string(threads);
+
+    while (std::getline(in, line))
+    {
+        std::istringstream row(line);
+        std::string operation;
+        int rowThreads;
+        double mean, deviation, p50, p90, p99, throughput;
+
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        if (!(row >> operation >> rowThreads >> mean >> deviation >> p50 >> p90 >> p99 >> throughput))
+            continue;
+
+        if (rowThreads != threads || mean <= 0)
+            continue;
+
+        for (int i = 0; i < operationKinds; i++)
+            if (operation == OperationName((Operation)i))
+            {
+                calibrated.seconds[i] = mean;
+                measured[i] = true;
+            }
+    }
+
+    for (int i = 0; i < operationKinds; i++)
+        if (!measured[i])
+            return false;
+
+    calibrated.secondsPerBootstrap = calibrated.seconds[(int)Operation::And] / calibrated.bootstraps[(int)Operation::And];
+    model = calibrated;
+
+    return true;
+}
+
+Computation::Computation() {
+    bootCount = 0;
+    encCount = 0;
+
+    for (int i = 0; i < operationKinds; i++)
+        operationCount[i] = 0;
+}
+
 void Computation::Bootstrap() {
     bootCount++;
 }
 
-void Computation::Encrypt() {
-    encCount++;
+void Computation::Encrypt() {
+    encCount++;
+    Record(Operation::Encrypt);
+}
+
+void Computation::Record(Operation operation) {
+    operationCount[(int)operation]++;
+}
+
+long long Computation::GetBootstrapping() {
+    return bootCount;
+}
+
+long long Computation::GetEncryptions() {
+    return encCount;
+}
+
+long long Computation::GetCount(Operation operation) const {
+    return operationCount[(int)operation];
+}
+
+double Computation::GetBootstrapping(const CostModel &model) const {
+    double total = 0;
+
+    for (int i = 0; i < operationKinds; i++)
+        total += operationCount[i] * model.bootstraps[i];
+
+    return total;
+}
+
+double Computation::GetTime(const CostModel &model) const {
+    double total = 0;
+
+    for (int i = 0; i < operationKinds; i++)
+        total += operationCount[i] * model.seconds[i];
+
+    return total;
+}
+
+void Computation::WriteJson(std::ostream &out, const std::vector<CostModel> &models) const {
+    bool first = true;
+
+    out << "{\"bootstrapping\": " << bootCount << ", \"operations\": {";
+
+    for (int i = 0; i < operationKinds; i++)
+    {
+        if (!IsCounted((Operation)i))
+            continue;
+
+        out << (first ? "" : ", ") << "\"" << OperationName((Operation)i) << "\": " << operationCount[i];
+        first = false;
+    }
+
+    out << "}, \"models\": [";
+
+    for (size_t i = 0; i < models.size(); i++)
+        out << (i ? ", " : "") << "{\"name\": \"" << models[i].name << "\", \"bootstraps\": " << GetBootstrapping(models[i])
+            << ", \"seconds\": " << GetTime(models[i]) << "}";
+
+    out << "]}" << std::endl;
+}
+
+// One row per operation kind with its count and its price under every model, then the totals
+void Computation::WriteCsv(std::ostream &out, const std::vector<CostModel> &models) const {
+    out << "operation,count";
+
+    for (size_t i = 0; i < models.size(); i++)
+        out << "," << models[i].name << " bootstraps," << models[i].name << " seconds";
+
+    out << std::endl;
+
+    for (int i = 0; i < operationKinds; i++)
+    {
+        if (!IsCounted((Operation)i))
+            continue;
+
+        out << OperationName((Operation)i) << "," << operationCount[i];
+
+        for (size_t j = 0; j < models.size(); j++)
+            out << "," << operationCount[i] * models[j].bootstraps[i] << "," << operationCount[i] * models[j].seconds[i];
+
+        out << std::endl;
+    }
+
+    out << "total,";
+
+    for (size_t i = 0; i < models.size(); i++)
+        out << "," << GetBootstrapping(models[i]) << "," << GetTime(models[i]);
+
+    out << std::endl;
+}
+
+// Counts a gate at its level; NOTs and anything else at level 0 costs no time on the critical path
+void Computation::Record(Operation operation, long long level) {
+    Record(operation);
+
+    if (level <= 0)
+        return;
+
+    if ((long long)levelCounts.size() < level)
+    {
+        std::array<long long, operationKinds> empty;
+        empty.fill(0);
+        levelCounts.resize(level, empty);
+    }
+
+    levelCounts[level - 1][(int)operation]++;
+}
+
+long long Computation::GetDepth() const {
+    return levelCounts.size();
+}
+
+long long Computation::GetWidth(long long level) const {
+    long long width = 0;
+
+    if (level < 1 || level > (long long)levelCounts.size())
+        return 0;
+
+    for (int i = 0; i < operationKinds; i++)
+        width += levelCounts[level - 1][i];
+
+    return width;
+}
+
+long long Computation::GetPeakWidth() const {
+    long long peak = 0;
+
+    for (long long i = 1; i <= GetDepth(); i++)
+        peak = std::max(peak, GetWidth(i));
+
+    return peak;
+}
+
+double Computation::GetAverageWidth() const {
+    long long total = 0;
+
+    for (long long i = 1; i <= GetDepth(); i++)
+        total += GetWidth(i);
+
+    return GetDepth() > 0 ? (double)total / GetDepth() : 0;
+}
+
+// Levels run one after another, and the gates of a level are spread over the cores longest
+// first, each on the least loaded core
+double Computation::GetMakespan(const CostModel &model, int cores) const {
+    double total = 0;
+    int order[operationKinds];
+
+    for (int i = 0; i < operationKinds; i++)
+        order[i] = i;
+
+    std::sort(order, order + operationKinds, [&model](int a, int b) { return model.seconds[a] > model.seconds[b]; });
+
+    for (size_t level = 0; level < levelCounts.size(); level++)
+    {
+        std::priority_queue<double, std::vector<double>, std::greater<double> > loads;
+        long long width = GetWidth(level + 1);
+        double longest = 0;
+
+        for (long long i = 0; i < std::min((long long)std::max(cores, 1), width); i++)
+            loads.push(0);
+
+        for (int i = 0; i < operationKinds && !loads.empty(); i++)
+        {
+            for (long long j = 0; j < levelCounts[level][order[i]]; j++)
+            {
+                double load = loads.top() + model.seconds[order[i]];
+
+                loads.pop();
+                loads.push(load);
+                longest = std::max(longest, load);
+            }
+        }
+
+        total += longest;
+    }
+
+    return total;
+}
+
+void Computation::WriteProfile(std::ostream &out, const CostModel &model, const std::vector<int> &cores) const {
+    out << "{\"depth\": " << GetDepth() << ", \"peakWidth\": " << GetPeakWidth() << ", \"averageWidth\": " << GetAverageWidth()
+        << ", \"model\": \"" << model.name << "\", \"levels\": [";
+
+    for (size_t i = 0; i < levelCounts.size(); i++)
+    {
+        bool first = true;
+
+        out << (i ? ", " : "") << "{";
+
+        for (int j = 0; j < operationKinds; j++)
+        {
+            if (levelCounts[i][j] == 0)
+                continue;
+
+            out << (first ? "" : ", ") << "\"" << OperationName((Operation)j) << "\": " << levelCounts[i][j];
+            first = false;
+        }
+
+        out << "}";
+    }
+
+    out << "], \"makespan\": [";
+
+    for (size_t i = 0; i < cores.size(); i++)
+        out << (i ? ", " : "") << "{\"cores\": " << cores[i] << ", \"seconds\": " << GetMakespan(model, cores[i])
+            << ", \"speedup\": " << GetMakespan(model, 1) / std::max(GetMakespan(model, cores[i]), 1e-12) << "}";
+
+    out << "]}" << std::endl;
+}
+
+int Circuit::AddInput() {
+    Gate gate = {GateType::Input, {(int)inputs.size(), -1, -1}};
+
+    gates.push_back(gate);
+    inputs.push_back(gates.size() - 1);
+    return gates.size() - 1;
+}
+
+int Circuit::AddConstant(bool n) {
+    if (constants[n] < 0)
+    {
+        Gate gate = {GateType::Constant, {n, -1, -1}};
+
+        gates.push_back(gate);
+        constants[n] = gates.size() - 1;
+    }
+
+    return constants[n];
+}
+
+int Circuit::AddGate(GateType type, int a, int b, int c) {
+    Gate gate = {type, {a, b, c}};
+
+    gates.push_back(gate);
+    return gates.size() - 1;
+}
+
+void Circuit::AddOutput(const RecordedBit &a) {
+    if (a.circuit == this)
+        outputs.push_back(a.id);
+    else
+        outputs.push_back(AddConstant(a.value));
+}
+
+template <int N>
+void Circuit::AddOutput(const GenericInt<N, RecordedBit> &a) {
+    for (int i = 0; i < N; i++)
+        AddOutput(a.encValue[i]);
+}
+
+long long Circuit::GetGateCount() const {
+    long long count = 0;
+
+    for (size_t i = 0; i < gates.size(); i++)
+        if (gates[i].type != GateType::Input && gates[i].type != GateType::Constant)
+            count++;
+
+    return count;
+}
+
+long long Circuit::GetGateCount(GateType type) const {
+    long long count = 0;
+
+    for (size_t i = 0; i < gates.size(); i++)
+        if (gates[i].type == type)
+            count++;
+
+    return count;
+}
+
+// Same pricing as SimulatedGateBootstrappedBit: NOT is free, MUX takes two bootstraps
+// and every other gate one
+long long Circuit::GetBootstrapping() const {
+    return GetGateCount() - GetGateCount(GateType::Not) + GetGateCount(GateType::Mux);
+}
+
+// Recorded gates priced as if the circuit were evaluated gate by gate
+double Circuit::GetBootstrapping(const CostModel &model) const {
+    double total = 0;
+
+    for (size_t i = 0; i < gates.size(); i++)
+        if (gates[i].type != GateType::Input && gates[i].type != GateType::Constant)
+            total += model.bootstraps[(int)OperationOf(gates[i].type)];
+
+    return total;
+}
+
+double Circuit::GetTime(const CostModel &model) const {
+    double total = 0;
+
+    for (size_t i = 0; i < gates.size(); i++)
+        if (gates[i].type != GateType::Input && gates[i].type != GateType::Constant)
+            total += model.seconds[(int)OperationOf(gates[i].type)];
+
+    return total;
+}
+
+// Level of every gate, counted in bootstrapped gates on the longest path from an input
+std::vector<long long> Circuit::GetLevels() const {
+    std::vector<long long> levels(gates.size(), 0);
+
+    for (size_t i = 0; i < gates.size(); i++)
+    {
+        const Gate &gate = gates[i];
+
+        switch (gate.type)
+        {
+            case GateType::Input:
+            case GateType::Constant:
+                levels[i] = 0;
+                break;
+            case GateType::Not:
+                levels[i] = levels[gate.input[0]];
+                break;
+            case GateType::Mux:
+                levels[i] = std::max(std::max(levels[gate.input[0]], levels[gate.input[1]]), levels[gate.input[2]]) + 1;
+                break;
+            default:
+                levels[i] = std::max(levels[gate.input[0]], levels[gate.input[1]]) + 1;
+        }
+    }
+
+    return levels;
+}
+
+long long Circuit::GetDepth() const {
+    std::vector<long long> levels = GetLevels();
+    long long depth = 0;
+
+    for (size_t i = 0; i < outputs.size(); i++)
+        depth = std::max(depth, levels[outputs[i]]);
+
+    return depth;
+}
+
+std::vector<bool> Circuit::Evaluate(const std::vector<bool> &inputValues) const {
+    std::vector<bool> values(gates.size()), result;
+
+    for (size_t i = 0; i < gates.size(); i++)
+    {
+        const Gate &gate = gates[i];
+
+        switch (gate.type)
+        {
+            case GateType::Input:
+                values[i] = inputValues[gate.input[0]];
+                break;
+            case GateType::Constant:
+                values[i] = gate.input[0];
+                break;
+            case GateType::Not:
+                values[i] = !values[gate.input[0]];
+                break;
+            case GateType::Mux:
+                values[i] = values[gate.input[0]] ? values[gate.input[1]] : values[gate.input[2]];
+                break;
+            default:
+                values[i] = GateOutput(OperationOf(gate.type), values[gate.input[0]], values[gate.input[1]]);
+        }
+    }
+
+    for (size_t i = 0; i < outputs.size(); i++)
+        result.push_back(values[outputs[i]]);
+
+    return result;
+}
+
+CiphertextArena::~CiphertextArena() {
+    Clear();
+}
+
+LweSample *CiphertextArena::Acquire() {
+    std::lock_guard<std::mutex> guard(lock);
+
+    live++;
+
+    if (samples.empty())
+        return new_gate_bootstrapping_ciphertext(params);
+
+    LweSample *sample = samples.back();
+    samples.pop_back();
+    return sample;
+}
+
+void CiphertextArena::Release(LweSample *sample) {
+    std::lock_guard<std::mutex> guard(lock);
+
+    live--;
+    samples.push_back(sample);
+}
+
+void CiphertextArena::Clear() {
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (size_t i = 0; i < samples.size(); i++)
+        delete_gate_bootstrapping_ciphertext(samples[i]);
+
+    samples.clear();
+}
+
+size_t CiphertextArena::GetFreeCount() {
+    std::lock_guard<std::mutex> guard(lock);
+
+    return samples.size();
+}
+
+size_t CiphertextArena::GetLiveCount() {
+    std::lock_guard<std::mutex> guard(lock);
+
+    return live;
+}
+
+FheContext::FheContext() {
+    params = NULL;
+    secretKey = NULL;
+    cloudKey = NULL;
+    ownParams = NULL;
+    ownCloudKey = NULL;
+    sharedKey = NULL;
+}
+
+FheContext::~FheContext() {
+    Clear();
+}
+
+// Pooled samples are sized for the old parameters, so they go along with the keys. A live
+// bit would go on using the freed parameters, and release its sample into the new pool.
+void FheContext::Clear() {
+    assert(arena.GetLiveCount() == 0 && "the keys of an FheContext changed while its bits are alive");
+    arena.Clear();
+
+    if (secretKey != NULL)
+        delete_gate_bootstrapping_secret_keyset(secretKey);
+    if (ownCloudKey != NULL)
+        delete_gate_bootstrapping_cloud_keyset(ownCloudKey);
+    if (ownParams != NULL)
+        delete_gate_bootstrapping_parameters(ownParams);
+
+    delete sharedKey;
+
+    params = NULL;
+    secretKey = NULL;
+    cloudKey = NULL;
+    ownParams = NULL;
+    ownCloudKey = NULL;
+    sharedKey = NULL;
+    arena.params = NULL;
+}
+
+void FheContext::Generate(int minimumLambda) {
+    Clear();
+
+    ownParams = new_default_gate_bootstrapping_parameters(minimumLambda);
+    secretKey = new_random_gate_bootstrapping_secret_keyset(ownParams);
+    params = ownParams;
+    cloudKey = &secretKey->cloud;
+    arena.params = params;
+}
+
+// A loaded keyset carries its own parameters, which tfhe_io allocates but does not free
+// along with the keyset, so the context takes them over
+bool FheContext::LoadSecretKey(const std::string &path) {
+    FILE *file = fopen(path.c_str(), "rb");
+
+    if (file == NULL)
+        return false;
+
+    Clear();
+    secretKey = new_tfheGateBootstrappingSecretKeySet_fromFile(file);
+    fclose(file);
+
+    if (secretKey == NULL)
+        return false;
+
+    ownParams = const_cast<TFheGateBootstrappingParameterSet*>(secretKey->params);
+    params = ownParams;
+    cloudKey = &secretKey->cloud;
+    arena.params = params;
+    return true;
+}
+
+bool FheContext::LoadCloudKey(const std::string &path) {
+    FILE *file = fopen(path.c_str(), "rb");
+
+    if (file == NULL)
+        return false;
+
+    Clear();
+    ownCloudKey = new_tfheGateBootstrappingCloudKeySet_fromFile(file);
+    fclose(file);
+
+    if (ownCloudKey == NULL)
+        return false;
+
+    ownParams = const_cast<TFheGateBootstrappingParameterSet*>(ownCloudKey->params);
+    params = ownParams;
+    cloudKey = ownCloudKey;
+    arena.params = params;
+    return true;
+}
+
+bool FheContext::SaveSecretKey(const std::string &path) const {
+    if (secretKey == NULL)
+        return false;
+
+    FILE *file = fopen(path.c_str(), "wb");
+
+    if (file == NULL)
+        return false;
+
+    export_tfheGateBootstrappingSecretKeySet_toFile(file, secretKey);
+    fclose(file);
+    return true;
+}
+
+bool FheContext::SaveCloudKey(const std::string &path) const {
+    if (cloudKey == NULL)
+        return false;
+
+    FILE *file = fopen(path.c_str(), "wb");
+
+    if (file == NULL)
+        return false;
+
+    export_tfheGateBootstrappingCloudKeySet_toFile(file, cloudKey);
+    fclose(file);
+    return true;
+}
+
+// The mapped key is read-only and shared with every other process mapping the same file
+bool FheContext::MapCloudKey(const std::string &path) {
+    Clear();
+    sharedKey = new SharedCloudKey();
+
+    if (!sharedKey->Map(path))
+    {
+        Clear();
+        return false;
+    }
+
+    params = sharedKey->params;
+    cloudKey = sharedKey->cloudKey;
+    arena.params = params;
+    return true;
+}
+
+bool FheContext::SaveSharedCloudKey(const std::string &path) const {
+    return SharedCloudKey::Save(cloudKey, path);
+}
+
+bool FheContext::HasSecretKey() const {
+    return secretKey != NULL;
+}
+
+// Without the secret key the bit is public to the evaluator anyway, so a noiseless
+// trivial encryption is as good as a real one
+void FheContext::Encrypt(LweSample *sample, bool n) {
+    if (secretKey != NULL)
+        bootsSymEncrypt(sample, n, secretKey);
+    else
+        bootsCONSTANT(sample, n, cloudKey);
+}
+
+// An evaluator context has no secret key to decrypt with; check HasSecretKey first
+bool FheContext::Decrypt(const LweSample *sample) const {
+    assert(secretKey != NULL && "Decrypt needs an FheContext with the secret key");
+
+    return bootsSymDecrypt(sample, secretKey);
+}
+
+RealGateBootstrappedBit::RealGateBootstrappedBit(FheContext &newContext, Uninitialized) {
+    context = &newContext;
+    plain = 0;
+    borrowed = false;
+    value = context->arena.Acquire();
+}
+
+RealGateBootstrappedBit::RealGateBootstrappedBit(FheContext &newContext, LweSample *sample) {
+    context = &newContext;
+    plain = 0;
+    borrowed = true;
+    value = sample;
+}
+
+RealGateBootstrappedBit::RealGateBootstrappedBit(const RealGateBootstrappedBit &a) {
+    context = a.context;
+    plain = a.plain;
+    borrowed = false;
+    value = NULL;
+
+    if (a.value != NULL)
+    {
+        value = context->arena.Acquire();
+        bootsCOPY(value, a.value, context->cloudKey);
+    }
+}
+
+RealGateBootstrappedBit::RealGateBootstrappedBit(RealGateBootstrappedBit &&a) noexcept {
+    context = a.context;
+    plain = a.plain;
+    borrowed = a.borrowed;
+    value = a.value;
+    a.value = NULL;
+}
+
+RealGateBootstrappedBit::~RealGateBootstrappedBit() {
+    if (value != NULL && !borrowed)
+        context->arena.Release(value);
+}
+
+// A borrowed ciphertext is dropped rather than overwritten. Two public constants both
+// have no ciphertext, so only a shared ciphertext means self-assignment.
+RealGateBootstrappedBit &RealGateBootstrappedBit::operator=(const RealGateBootstrappedBit &a) {
+    if (value != NULL && value == a.value)
+        return *this;
+
+    if (value != NULL && (borrowed || a.value == NULL || context != a.context))
+    {
+        if (!borrowed)
+            context->arena.Release(value);
+        value = NULL;
+    }
+
+    context = a.context;
+    plain = a.plain;
+    borrowed = false;
+
+    if (a.value != NULL)
+    {
+        if (value == NULL)
+            value = context->arena.Acquire();
+
+        bootsCOPY(value, a.value, context->cloudKey);
+    }
+
+    return *this;
+}
+
+RealGateBootstrappedBit &RealGateBootstrappedBit::operator=(RealGateBootstrappedBit &&a) noexcept {
+    std::swap(value, a.value);
+    std::swap(plain, a.plain);
+    std::swap(borrowed, a.borrowed);
+    std::swap(context, a.context);
+
+    return *this;
+}
+
+void RealGateBootstrappedBit::Initialize(FheContext &newContext) {
+    Initialize(plain, newContext);
+}
+
+void RealGateBootstrappedBit::Initialize(bool n, FheContext &newContext) {
+    if (value != NULL && !borrowed)
+        context->arena.Release(value);
+
+    context = &newContext;
+    plain = n;
+    borrowed = false;
+    value = context->arena.Acquire();
+    context->Encrypt(value, n);
+}
+
+bool RealGateBootstrappedBit::Decrypt() const {
+    if (value == NULL)
+        return plain;
+
+    return context->Decrypt(value);
+}
+
+// A gate against a public constant reduces to a copy, a negation or another constant
+RealGateBootstrappedBit ApplyGate(Operation operation, const RealGateBootstrappedBit &a, const RealGateBootstrappedBit &b) {
+    if (a.value == NULL && b.value == NULL)
+        return RealGateBootstrappedBit(GateOutput(operation, a.plain, b.plain));
+
+    if (a.value == NULL || b.value == NULL)
+    {
+        const RealGateBootstrappedBit &wire = a.value == NULL ? b : a;
+        bool low = a.value == NULL ? GateOutput(operation, a.plain, 0) : GateOutput(operation, 0, b.plain);
+        bool high = a.value == NULL ? GateOutput(operation, a.plain, 1) : GateOutput(operation, 1, b.plain);
+
+        if (low == high)
+            return RealGateBootstrappedBit(low);
+
+        return high ? wire : !wire;
+    }
+
+    RealGateBootstrappedBit c(*a.context, uninitialized);
+
+    BootsGate(operation, c.value, a.value, b.value, a.context->cloudKey);
+    return c;
+}
+
+RealGateBootstrappedBit RealGateBootstrappedBit::operator&(const RealGateBootstrappedBit &a) const {
+    return ApplyGate(Operation::And, *this, a);
+}
+
+RealGateBootstrappedBit RealGateBootstrappedBit::operator^(const RealGateBootstrappedBit &a) const {
+    return ApplyGate(Operation::Xor, *this, a);
+}
+
+RealGateBootstrappedBit RealGateBootstrappedBit::operator|(const RealGateBootstrappedBit &a) const {
+    return ApplyGate(Operation::Or, *this, a);
+}
+
+RealGateBootstrappedBit RealGateBootstrappedBit::operator!() const {
+    if (value == NULL)
+        return RealGateBootstrappedBit(!plain);
+
+    RealGateBootstrappedBit b(*context, uninitialized);
+
+    bootsNOT(b.value, value, context->cloudKey);
+    return b;
+}
+
+// Constant data inputs of a MUX with an encrypted selector are made trivial ciphertexts
+RealGateBootstrappedBit mux(const RealGateBootstrappedBit &a, const RealGateBootstrappedBit &b, const RealGateBootstrappedBit &c) {
+    if (a.value == NULL)
+        return a.plain ? b : c;
+    if (b.value == NULL && c.value == NULL)
+        return b.plain == c.plain ? b : (b.plain ? a : !a);
+
+    FheContext *context = a.context;
+    RealGateBootstrappedBit d(*context, uninitialized), constant(*context, uninitialized);
+    const LweSample *trueInput = b.value, *falseInput = c.value;
+
+    if (trueInput == NULL)
+    {
+        bootsCONSTANT(constant.value, b.plain, context->cloudKey);
+        trueInput = constant.value;
+    }
+    else if (falseInput == NULL)
+    {
+        bootsCONSTANT(constant.value, c.plain, context->cloudKey);
+        falseInput = constant.value;
+    }
+
+    bootsMUX(d.value, a.value, trueInput, falseInput, context->cloudKey);
+
+    return d;
+}
+
+void SimulatedGateBootstrappedBit::Initialize(Computation &newComputation) {
+    routine = &newComputation;
+    routine->Encrypt();
+}
+
+void SimulatedGateBootstrappedBit::Initialize(bool n, Computation &newComputation) {
+    value = n;
+    routine = &newComputation;
+    routine->Encrypt();
 }
 
-long long Computation::GetBootstrapping() {
-    return bootCount;
+// Every two-input gate is a single bootstrap
+SimulatedGateBootstrappedBit ApplyGate(Operation operation, const SimulatedGateBootstrappedBit &a, const SimulatedGateBootstrappedBit &b) {
+    SimulatedGateBootstrappedBit c;
+
+    c.value = GateOutput(operation, a.value, b.value);
+    c.routine = a.routine != NULL ? a.routine : b.routine;
+
+    if (c.routine != NULL)
+    {
+        c.routine->Record(operation);
+        c.routine->Bootstrap();
+    }
+
+    return c;
 }
 
-long long Computation::GetEncryptions() {
-    return encCount;
+SimulatedGateBootstrappedBit SimulatedGateBootstrappedBit::operator&(const SimulatedGateBootstrappedBit &a) const {
+    return ApplyGate(Operation::And, *this, a);
 }
 
-void RealGateBootstrappedBit::operator=(const RealGateBootstrappedBit &a) const {
-    bootsCOPY(value, a.value, &key->cloud);
+SimulatedGateBootstrappedBit SimulatedGateBootstrappedBit::operator^(const SimulatedGateBootstrappedBit &a) const {
+    return ApplyGate(Operation::Xor, *this, a);
 }
 
-RealGateBootstrappedBit RealGateBootstrappedBit::operator&(const RealGateBootstrappedBit &a) const {
-    RealGateBootstrappedBit b(0);
+SimulatedGateBootstrappedBit SimulatedGateBootstrappedBit::operator|(const SimulatedGateBootstrappedBit &a) const {
+    return ApplyGate(Operation::Or, *this, a);
+}
+
+SimulatedGateBootstrappedBit SimulatedGateBootstrappedBit::operator!() const {
+    SimulatedGateBootstrappedBit b;
+
+    b.value = !value;
+    b.routine = routine;
+
+    if (b.routine != NULL)
+        b.routine->Record(Operation::Not);
 
-    bootsAND(b.value, value, a.value, &key->cloud);
     return b;
 }
 
-RealGateBootstrappedBit RealGateBootstrappedBit::operator^(const RealGateBootstrappedBit &a) const {
-    RealGateBootstrappedBit b(0);
+SimulatedGateBootstrappedBit mux(SimulatedGateBootstrappedBit a, SimulatedGateBootstrappedBit b, SimulatedGateBootstrappedBit c) {
+    SimulatedGateBootstrappedBit d;
 
-    bootsXOR(b.value, value, a.value, &key->cloud);
-    return b;
+    d.value = a.value ? b.value : c.value;
+    d.routine = a.routine != NULL ? a.routine : (b.routine != NULL ? b.routine : c.routine);
+
+    if (d.routine != NULL) {
+        d.routine -> Record(Operation::Mux);
+        d.routine -> Bootstrap();
+        d.routine -> Bootstrap();
+    }
+    return d;
 }
 
-RealGateBootstrappedBit RealGateBootstrappedBit::operator|(const RealGateBootstrappedBit &a) const {
-    RealGateBootstrappedBit b(0);
+void SimulatedCircuitBootstrappedBit::Initialize(Computation &newComputation) {
+    routine = &newComputation;
+    routine->Encrypt();
+}
 
-    bootsOR(b.value, value, a.value, &key->cloud);
-    return b;
+void SimulatedCircuitBootstrappedBit::Initialize(bool n, Computation &newComputation) {
+    value = n;
+    routine = &newComputation;
+    routine->Encrypt();
 }
 
-RealGateBootstrappedBit RealGateBootstrappedBit::operator!() const {
-    RealGateBootstrappedBit b(0);
+SimulatedCircuitBootstrappedBit ApplyGate(Operation operation, const SimulatedCircuitBootstrappedBit &a, const SimulatedCircuitBootstrappedBit &b) {
+    SimulatedCircuitBootstrappedBit c;
+
+    c.value = GateOutput(operation, a.value, b.value);
+    c.routine = a.routine != NULL ? a.routine : b.routine;
+    c.level = std::max(a.level, b.level) + 1;
+
+    if (c.routine != NULL)
+        c.routine->Record(operation);
+
+    if (c.routine != NULL && c.routine->GetBootstrapping() < c.level)
+        c.routine->Bootstrap();
+
+    return c;
+}
+
+SimulatedCircuitBootstrappedBit SimulatedCircuitBootstrappedBit::operator&(const SimulatedCircuitBootstrappedBit &a) const {
+    return ApplyGate(Operation::And, *this, a);
+}
+
+SimulatedCircuitBootstrappedBit SimulatedCircuitBootstrappedBit::operator^(const SimulatedCircuitBootstrappedBit &a) const {
+    return ApplyGate(Operation::Xor, *this, a);
+}
+
+SimulatedCircuitBootstrappedBit SimulatedCircuitBootstrappedBit::operator|(const SimulatedCircuitBootstrappedBit &a) const {
+    return ApplyGate(Operation::Or, *this, a);
+}
+
+SimulatedCircuitBootstrappedBit SimulatedCircuitBootstrappedBit::operator!() const {
+    SimulatedCircuitBootstrappedBit b;
+
+    b.value = !value;
+    b.routine = routine;
+
+    if (b.routine != NULL)
+        b.routine->Record(Operation::Not);
+    b.level = level;
 
-    bootsNOT(b.value, value, &key->cloud);
     return b;
 }
 
-RealGateBootstrappedBit mux(RealGateBootstrappedBit a, RealGateBootstrappedBit b, RealGateBootstrappedBit c) {
-    RealGateBootstrappedBit d;
+SimulatedCircuitBootstrappedBit mux(SimulatedCircuitBootstrappedBit a, SimulatedCircuitBootstrappedBit b, SimulatedCircuitBootstrappedBit c) {
+    SimulatedCircuitBootstrappedBit d;
+
+    d.value = a.value ? b.value : c.value;
+    d.routine = a.routine != NULL ? a.routine : (b.routine != NULL ? b.routine : c.routine);
+
+    if(d.routine != NULL) {
+        d.routine -> Record(Operation::Mux);
+    }
+
+    if(d.routine != NULL && std::max(a.level, b.level) + 1 > d.routine -> GetBootstrapping()) {
+        d.routine -> Bootstrap();
+    }
+
+    if(d.routine != NULL && std::max(a.level, c.level) + 1 > d.routine -> GetBootstrapping()) {
+        d.routine -> Bootstrap();
+    }
 
-    bootsMUX(d.value, a.value, b.value, c.value, &key->cloud);
+    d.level = std::max(std::max(a.level, b.level), c.level) + 1;
 
     return d;
 }
 
-void SimulatedGateBootstrappedBit::Initialize(Computation &newComputation) {
+void ProfiledBit::Initialize(Computation &newComputation) {
     routine = &newComputation;
     routine->Encrypt();
 }
 
-void SimulatedGateBootstrappedBit::Initialize(bool n, Computation &newComputation) {
+void ProfiledBit::Initialize(bool n, Computation &newComputation) {
     value = n;
     routine = &newComputation;
     routine->Encrypt();
 }
 
-SimulatedGateBootstrappedBit SimulatedGateBootstrappedBit::operator&(const SimulatedGateBootstrappedBit &a) const {
-    SimulatedGateBootstrappedBit b;
+ProfiledBit ApplyGate(Operation operation, const ProfiledBit &a, const ProfiledBit &b) {
+    ProfiledBit c;
+
+    c.value = GateOutput(operation, a.value, b.value);
+    c.routine = a.routine != NULL ? a.routine : b.routine;
+    c.level = std::max(a.level, b.level) + 1;
+
+    if (c.routine != NULL)
+    {
+        c.routine->Record(operation, c.level);
+        c.routine->Bootstrap();
+    }
+
+    return c;
+}
+
+ProfiledBit ProfiledBit::operator&(const ProfiledBit &a) const {
+    return ApplyGate(Operation::And, *this, a);
+}
+
+ProfiledBit ProfiledBit::operator^(const ProfiledBit &a) const {
+    return ApplyGate(Operation::Xor, *this, a);
+}
+
+ProfiledBit ProfiledBit::operator|(const ProfiledBit &a) const {
+    return ApplyGate(Operation::Or, *this, a);
+}
+
+ProfiledBit ProfiledBit::operator!() const {
+    ProfiledBit b;
 
-    b.value = value & a.value;
+    b.value = !value;
     b.routine = routine;
+    b.level = level;
+
+    if (b.routine != NULL)
+        b.routine->Record(Operation::Not, 0);
 
-    routine->Bootstrap();
     return b;
 }
 
-SimulatedGateBootstrappedBit SimulatedGateBootstrappedBit::operator^(const SimulatedGateBootstrappedBit &a) const {
-    SimulatedGateBootstrappedBit b;
+// Both bootstraps of a TFHE MUX read the operands, so the MUX takes a single level
+ProfiledBit mux(ProfiledBit a, ProfiledBit b, ProfiledBit c) {
+    ProfiledBit d;
+
+    d.value = a.value ? b.value : c.value;
+    d.routine = a.routine != NULL ? a.routine : (b.routine != NULL ? b.routine : c.routine);
+    d.level = std::max(std::max(a.level, b.level), c.level) + 1;
+
+    if (d.routine != NULL)
+    {
+        d.routine->Record(Operation::Mux, d.level);
+        d.routine->Bootstrap();
+        d.routine->Bootstrap();
+    }
+
+    return d;
+}
+
+void SimulatedLevelledBit::Initialize(long long newDepth, Computation &newComputation) {
+    depth = newDepth;
+    routine = &newComputation;
+    routine->Encrypt();
+}
+
+void SimulatedLevelledBit::Initialize(bool n, long long newDepth, Computation &newComputation) {
+    value = n;
+    depth = newDepth;
+    routine = &newComputation;
+    routine->Encrypt();
+}
+
+SimulatedLevelledBit ApplyGate(Operation operation, const SimulatedLevelledBit &a, const SimulatedLevelledBit &b) {
+    SimulatedLevelledBit c;
+
+    c.value = GateOutput(operation, a.value, b.value);
+    c.routine = a.routine != NULL ? a.routine : b.routine;
+    c.level = std::max(a.level, b.level) + 1;
+    c.depth = a.routine != NULL ? a.depth : b.depth;
+
+    if (c.routine != NULL)
+        c.routine->Record(operation);
+
+    if (c.routine != NULL && c.depth < c.level)
+    {
+        c.level = 0;
+        c.routine->Bootstrap();
+    }
+
+    return c;
+}
+
+SimulatedLevelledBit SimulatedLevelledBit::operator&(const SimulatedLevelledBit &a) const {
+    return ApplyGate(Operation::And, *this, a);
+}
+
+SimulatedLevelledBit SimulatedLevelledBit::operator^(const SimulatedLevelledBit &a) const {
+    return ApplyGate(Operation::Xor, *this, a);
+}
+
+SimulatedLevelledBit SimulatedLevelledBit::operator|(const SimulatedLevelledBit &a) const {
+    return ApplyGate(Operation::Or, *this, a);
+}
 
-    b.value = value ^ a.value;
+SimulatedLevelledBit SimulatedLevelledBit::operator!() const {
+    SimulatedLevelledBit b;
+
+    b.value = !value;
     b.routine = routine;
 
-    routine->Bootstrap();
-    return b;
+    if (b.routine != NULL)
+        b.routine->Record(Operation::Not);
+    b.depth = depth;
+    b.level = level;
+
+    return b;
+}
+
+// A levelled MUX is c + a (b - c), a single multiplication deep
+SimulatedLevelledBit mux(SimulatedLevelledBit a, SimulatedLevelledBit b, SimulatedLevelledBit c) {
+    SimulatedLevelledBit d;
+
+    d.value = a.value ? b.value : c.value;
+    d.routine = a.routine != NULL ? a.routine : (b.routine != NULL ? b.routine : c.routine);
+    d.level = std::max(std::max(a.level, b.level), c.level) + 1;
+    d.depth = a.routine != NULL ? a.depth : (b.routine != NULL ? b.depth : c.depth);
+
+    if (d.routine != NULL)
+        d.routine->Record(Operation::Mux);
+
+    if (d.routine != NULL && d.depth < d.level)
+    {
+        d.level = 0;
+        d.routine->Bootstrap();
+    }
+
+    return d;
+}
+
+void RecordedBit::Initialize(Circuit &newCircuit) {
+    circuit = &newCircuit;
+    id = circuit->AddInput();
+}
+
+void RecordedBit::Initialize(bool n, Circuit &newCircuit) {
+    value = n;
+    circuit = &newCircuit;
+    id = circuit->AddInput();
+}
+
+// Constants are kept off the graph until they meet a recorded wire
+int RecordedOperand(Circuit *circuit, const RecordedBit &a) {
+    if (a.circuit == circuit)
+        return a.id;
+
+    return circuit->AddConstant(a.value);
+}
+
+RecordedBit RecordedGate(GateType type, bool value, const RecordedBit &a, const RecordedBit &b) {
+    RecordedBit c(value);
+
+    c.circuit = a.circuit != NULL ? a.circuit : b.circuit;
+    if (c.circuit != NULL)
+        c.id = c.circuit->AddGate(type, RecordedOperand(c.circuit, a), RecordedOperand(c.circuit, b));
+
+    return c;
+}
+
+RecordedBit ApplyGate(Operation operation, const RecordedBit &a, const RecordedBit &b) {
+    return RecordedGate(GateOf(operation), GateOutput(operation, a.value, b.value), a, b);
+}
+
+RecordedBit RecordedBit::operator&(const RecordedBit &a) const {
+    return ApplyGate(Operation::And, *this, a);
+}
+
+RecordedBit RecordedBit::operator^(const RecordedBit &a) const {
+    return ApplyGate(Operation::Xor, *this, a);
+}
+
+RecordedBit RecordedBit::operator|(const RecordedBit &a) const {
+    return ApplyGate(Operation::Or, *this, a);
+}
+
+RecordedBit RecordedBit::operator!() const {
+    RecordedBit b(!value);
+
+    b.circuit = circuit;
+    if (circuit != NULL)
+        b.id = circuit->AddGate(GateType::Not, id);
+
+    return b;
+}
+
+RecordedBit mux(RecordedBit a, RecordedBit b, RecordedBit c) {
+    RecordedBit d(a.value ? b.value : c.value);
+
+    d.circuit = a.circuit != NULL ? a.circuit : (b.circuit != NULL ? b.circuit : c.circuit);
+    if (d.circuit != NULL)
+        d.id = d.circuit->AddGate(GateType::Mux, RecordedOperand(d.circuit, a), RecordedOperand(d.circuit, b), RecordedOperand(d.circuit, c));
+
+    return d;
+}
+
+bool mux(bool a, bool b, bool c) {
+    bool d;
+
+    d = a ? b : c;
+
+    return d;
+}
+
+bool ApplyGate(Operation operation, bool a, bool b) {
+    return GateOutput(operation, a, b);
+}
+
+// The rest of TFHE's gate library on every bit type, each a single bootstrap like AND
+template <class BoolType>
+BoolType xnor(const BoolType &a, const BoolType &b) {
+    return ApplyGate(Operation::Xnor, a, b);
+}
+
+template <class BoolType>
+BoolType nand(const BoolType &a, const BoolType &b) {
+    return ApplyGate(Operation::Nand, a, b);
+}
+
+template <class BoolType>
+BoolType nor(const BoolType &a, const BoolType &b) {
+    return ApplyGate(Operation::Nor, a, b);
+}
+
+// !a & b
+template <class BoolType>
+BoolType andny(const BoolType &a, const BoolType &b) {
+    return ApplyGate(Operation::AndNY, a, b);
+}
+
+// a & !b
+template <class BoolType>
+BoolType andyn(const BoolType &a, const BoolType &b) {
+    return ApplyGate(Operation::AndYN, a, b);
+}
+
+// !a | b
+template <class BoolType>
+BoolType orny(const BoolType &a, const BoolType &b) {
+    return ApplyGate(Operation::OrNY, a, b);
+}
+
+// a | !b
+template <class BoolType>
+BoolType oryn(const BoolType &a, const BoolType &b) {
+    return ApplyGate(Operation::OrYN, a, b);
+}
+
+template <class BoolType>
+FoldedBit<BoolType> FoldedNot(const FoldedBit<BoolType> &a) {
+    if (a.known >= 0)
+        return FoldedBit<BoolType>::Constant(!a.known);
+
+    FoldedBit<BoolType> b = a;
+
+    b.negated = !a.negated;
+    return b;
+}
+
+template <class BoolType>
+BoolType FoldedValue(const FoldedBit<BoolType> &a) {
+    if (a.known >= 0)
+        return BoolType(a.known);
+    if (a.negated)
+        return !a.bit;
+
+    return a.bit;
+}
+
+// Negated inputs select ANDNY, ANDYN or NOR instead of NOT gates in front of an AND
+template <class BoolType>
+FoldedBit<BoolType> FoldedAnd(const FoldedBit<BoolType> &a, const FoldedBit<BoolType> &b) {
+    if (a.known == 0 || b.known == 0)
+        return FoldedBit<BoolType>::Constant(0);
+    if (a.known == 1)
+        return b;
+    if (b.known == 1)
+        return a;
+
+    if (a.negated && b.negated)
+        return FoldedBit<BoolType>::Wire(nor(a.bit, b.bit));
+    if (a.negated)
+        return FoldedBit<BoolType>::Wire(andny(a.bit, b.bit));
+    if (b.negated)
+        return FoldedBit<BoolType>::Wire(andyn(a.bit, b.bit));
+
+    return FoldedBit<BoolType>::Wire(a.bit & b.bit);
+}
+
+template <class BoolType>
+FoldedBit<BoolType> FoldedOr(const FoldedBit<BoolType> &a, const FoldedBit<BoolType> &b) {
+    if (a.known == 1 || b.known == 1)
+        return FoldedBit<BoolType>::Constant(1);
+    if (a.known == 0)
+        return b;
+    if (b.known == 0)
+        return a;
+
+    if (a.negated && b.negated)
+        return FoldedBit<BoolType>::Wire(nand(a.bit, b.bit));
+    if (a.negated)
+        return FoldedBit<BoolType>::Wire(orny(a.bit, b.bit));
+    if (b.negated)
+        return FoldedBit<BoolType>::Wire(oryn(a.bit, b.bit));
+
+    return FoldedBit<BoolType>::Wire(a.bit | b.bit);
+}
+
+template <class BoolType>
+FoldedBit<BoolType> FoldedXor(const FoldedBit<BoolType> &a, const FoldedBit<BoolType> &b) {
+    if (a.known >= 0 && b.known >= 0)
+        return FoldedBit<BoolType>::Constant(a.known ^ b.known);
+    if (a.known >= 0)
+        return a.known ? FoldedNot(b) : b;
+    if (b.known >= 0)
+        return b.known ? FoldedNot(a) : a;
+
+    if (a.negated != b.negated)
+        return FoldedBit<BoolType>::Wire(xnor(a.bit, b.bit));
+
+    return FoldedBit<BoolType>::Wire(a.bit ^ b.bit);
+}
+
+template <class BoolType>
+FoldedBit<BoolType> FoldedMux(const FoldedBit<BoolType> &a, const FoldedBit<BoolType> &b, const FoldedBit<BoolType> &c) {
+    if (a.known >= 0)
+        return a.known ? b : c;
+    if (b.known >= 0 && c.known >= 0)
+        return b.known == c.known ? b : (b.known ? a : FoldedNot(a));
+    if (b.known == 0)
+        return FoldedAnd(FoldedNot(a), c);
+    if (b.known == 1)
+        return FoldedOr(a, c);
+    if (c.known == 0)
+        return FoldedAnd(a, b);
+    if (c.known == 1)
+        return FoldedOr(FoldedNot(a), b);
+
+    // A negated selector swaps the inputs, and negated inputs move to the output
+    if (a.negated)
+        return FoldedMux(FoldedNot(a), c, b);
+    if (b.negated && c.negated)
+        return FoldedNot(FoldedMux(a, FoldedNot(b), FoldedNot(c)));
+
+    return FoldedBit<BoolType>::Wire(mux(a.bit, FoldedValue(b), FoldedValue(c)));
+}
+
+// Combine steps (i, j) of a prefix network over n nodes: node i becomes node i
+// combined with the lower node j. Steps are listed in a valid sequential order.
+std::vector<std::pair<int, int> > PrefixSchedule(int n, AdderType type) {
+    std::vector<std::pair<int, int> > schedule;
+
+    switch (type)
+    {
+        case AdderType::RippleCarry:
+            for (int i = 1; i < n; i++)
+                schedule.push_back(std::make_pair(i, i - 1));
+            break;
+        case AdderType::KoggeStone:
+            for (int d = 1; d < n; d *= 2)
+                for (int i = n - 1; i >= d; i--)
+                    schedule.push_back(std::make_pair(i, i - d));
+            break;
+        case AdderType::BrentKung:
+        {
+            int d = 1;
+
+            for (; 2 * d <= n; d *= 2)
+                for (int i = 2 * d - 1; i < n; i += 2 * d)
+                    schedule.push_back(std::make_pair(i, i - d));
+
+            for (d /= 2; d >= 1; d /= 2)
+                for (int i = 3 * d - 1; i < n; i += 2 * d)
+                    schedule.push_back(std::make_pair(i, i - d));
+            break;
+        }
+        case AdderType::Sklansky:
+            for (int d = 1; d < n; d *= 2)
+                for (int i = 0; i < n; i++)
+                    if (i & d)
+                        schedule.push_back(std::make_pair(i, (i & ~(d - 1)) - 1));
+            break;
+    }
+
+    return schedule;
 }
 
-SimulatedGateBootstrappedBit SimulatedGateBootstrappedBit::operator|(const SimulatedGateBootstrappedBit &a) const {
-    SimulatedGateBootstrappedBit b;
-
-    b.value = value | a.value;
-    b.routine = routine;
+// A prefix schedule with, for every step, whether the propagate of the combined node is
+// read by a later step. Plans depend only on the width and the adder, so each thread
+// builds one per pair and every later addition reuses it without allocating.
+struct PrefixPlan {
+    std::vector<std::pair<int, int> > schedule;
+    std::vector<bool> computePropagate;
+};
 
-    routine->Bootstrap();
-    return b;
-}
+const PrefixPlan &GetPrefixPlan(int n, AdderType type) {
+    static thread_local std::map<std::pair<int, int>, PrefixPlan> plans;
+    std::pair<int, int> key(n, (int)type);
+    std::map<std::pair<int, int>, PrefixPlan>::iterator found = plans.find(key);
 
-SimulatedGateBootstrappedBit SimulatedGateBootstrappedBit::operator!() const {
-    SimulatedGateBootstrappedBit b;
+    if (found != plans.end())
+        return found->second;
 
-    b.value = !value;
-    b.routine = routine;
+    PrefixPlan &plan = plans[key];
+    std::vector<bool> needPropagate(n, false);
 
-    return b;
-}
+    plan.schedule = PrefixSchedule(n, type);
+    plan.computePropagate.resize(plan.schedule.size());
 
-SimulatedGateBootstrappedBit mux(SimulatedGateBootstrappedBit a, SimulatedGateBootstrappedBit b, SimulatedGateBootstrappedBit c) {
-    SimulatedGateBootstrappedBit d;
+    // Propagate of a combined node is only worth computing when a later step reads it
+    for (int s = plan.schedule.size() - 1; s >= 0; s--)
+    {
+        int i = plan.schedule[s].first, j = plan.schedule[s].second;
 
-    d.value = a.value ? b.value : c.value;
+        plan.computePropagate[s] = needPropagate[i];
+        needPropagate[j] = needPropagate[j] || needPropagate[i];
+        needPropagate[i] = true;
+    }
 
-    d.routine -> Bootstrap();
-    d.routine -> Bootstrap();
-    return d;
+    return plan;
 }
 
-void SimulatedCircuitBootstrappedBit::Initialize(Computation &newComputation) {
-    routine = &newComputation;
-    routine->Encrypt();
+// Bit strings are std::array when their width is the GenericInt's and std::vector when it
+// is only known at run time; scratch strings take the width of an operand
+template <class T>
+void ResizeBits(std::vector<T> &bits, size_t n) {
+    bits.resize(n);
 }
 
-void SimulatedCircuitBootstrappedBit::Initialize(bool n, Computation &newComputation) {
-    value = n;
-    routine = &newComputation;
-    routine->Encrypt();
+template <class T, size_t N>
+void ResizeBits(std::array<T, N> &, size_t) {
 }
 
-SimulatedCircuitBootstrappedBit SimulatedCircuitBootstrappedBit::operator&(const SimulatedCircuitBootstrappedBit &a) const {
-    SimulatedCircuitBootstrappedBit b;
+// Parallel-prefix carry computation over the generate/propagate pairs of an
+// addition of equal-width operands; the carry out of the top bit is dropped.
+// Node 0 holds the carry-in and node k holds bit k - 1, so after the scan the
+// generate of node i is the carry into bit i.
+template <class Bits>
+Bits AddBits(const Bits &a, const Bits &b, const typename Bits::value_type &carry, AdderType type) {
+    typedef typename Bits::value_type Folded;
+    int n = a.size();
+    Bits propagate, nodeGenerate, nodePropagate, sum;
+    const PrefixPlan &plan = GetPrefixPlan(n, type);
+    const std::vector<std::pair<int, int> > &schedule = plan.schedule;
+
+    ResizeBits(propagate, n);
+    ResizeBits(nodeGenerate, n);
+    ResizeBits(nodePropagate, n);
+    ResizeBits(sum, n);
+
+    for (int i = 0; i < n; i++)
+        propagate[i] = FoldedXor(a[i], b[i]);
+
+    if (n > 0)
+    {
+        nodeGenerate[0] = carry;
+        nodePropagate[0] = Folded::Constant(0);
+    }
+    for (int i = 1; i < n; i++)
+    {
+        nodeGenerate[i] = FoldedAnd(a[i - 1], b[i - 1]);
+        nodePropagate[i] = propagate[i - 1];
+    }
 
-    b.value = value & a.value;
-    b.routine = routine;
-    b.level = std::max(level, a.level) + 1;
+    for (size_t s = 0; s < schedule.size(); s++)
+    {
+        int i = schedule[s].first, j = schedule[s].second;
 
-    if (routine->GetBootstrapping() < b.level)
-        routine->Bootstrap();
+        nodeGenerate[i] = FoldedOr(nodeGenerate[i], FoldedAnd(nodePropagate[i], nodeGenerate[j]));
+        if (plan.computePropagate[s])
+            nodePropagate[i] = FoldedAnd(nodePropagate[i], nodePropagate[j]);
+    }
 
-    return b;
+    for (int i = 0; i < n; i++)
+        sum[i] = FoldedXor(propagate[i], nodeGenerate[i]);
+
+    return sum;
 }
 
-SimulatedCircuitBootstrappedBit SimulatedCircuitBootstrappedBit::operator^(const SimulatedCircuitBootstrappedBit &a) const {
-    SimulatedCircuitBootstrappedBit b;
+template <class Bits>
+Bits SubtractBits(const Bits &a, const Bits &b, AdderType type) {
+    Bits complement;
 
-    b.value = value ^ a.value;
-    b.routine = routine;
-    b.level = std::max(level, a.level) + 1;
+    ResizeBits(complement, b.size());
 
-    if (routine->GetBootstrapping() < b.level)
-        routine->Bootstrap();
+    for (size_t i = 0; i < b.size(); i++)
+        complement[i] = FoldedNot(b[i]);
 
-    return b;
+    return AddBits(a, complement, Bits::value_type::Constant(1), type);
 }
 
-SimulatedCircuitBootstrappedBit SimulatedCircuitBootstrappedBit::operator|(const SimulatedCircuitBootstrappedBit &a) const {
-    SimulatedCircuitBootstrappedBit b;
+// Bits [offset, offset + width) of a, padded with known zeros
+template <class Bits>
+std::vector<typename Bits::value_type> SliceBits(const Bits &a, int offset, int width) {
+    std::vector<typename Bits::value_type> slice(width, Bits::value_type::Constant(0));
 
-    b.value = value | a.value;
-    b.routine = routine;
-    b.level = std::max(level, a.level) + 1;
+    for (int i = 0; i < width; i++)
+        if (offset + i >= 0 && offset + i < (int)a.size())
+            slice[i] = a[offset + i];
 
-    if (routine->GetBootstrapping() < b.level)
-        routine->Bootstrap();
+    return slice;
+}
 
-    return b;
+// Columns of the partial products a_j b_i with i + j < width; known zeros are left out
+template <class Bits>
+std::vector<std::vector<typename Bits::value_type> > PartialProducts(const Bits &a, const Bits &b, int width) {
+    std::vector<std::vector<typename Bits::value_type> > columns(width);
+
+    for (int i = 0; i < (int)b.size() && i < width; i++)
+        for (int j = 0; j < (int)a.size() && i + j < width; j++)
+        {
+            typename Bits::value_type product = FoldedAnd(a[j], b[i]);
+
+            if (product.known != 0)
+                columns[i + j].push_back(product);
+        }
+
+    return columns;
 }
 
-SimulatedCircuitBootstrappedBit SimulatedCircuitBootstrappedBit::operator!() const {
-    SimulatedCircuitBootstrappedBit b;
+template <class BoolType>
+void FullAdder(const FoldedBit<BoolType> &a, const FoldedBit<BoolType> &b, const FoldedBit<BoolType> &c, FoldedBit<BoolType> &sum, FoldedBit<BoolType> &carry) {
+    FoldedBit<BoolType> temp = FoldedXor(a, b);
 
-    b.value = !value;
-    b.routine = routine;
-    b.level = level;
+    sum = FoldedXor(temp, c);
+    carry = FoldedOr(FoldedAnd(a, b), FoldedAnd(temp, c));
+}
 
-    return b;
+template <class BoolType>
+void HalfAdder(const FoldedBit<BoolType> &a, const FoldedBit<BoolType> &b, FoldedBit<BoolType> &sum, FoldedBit<BoolType> &carry) {
+    sum = FoldedXor(a, b);
+    carry = FoldedAnd(a, b);
 }
 
-SimulatedCircuitBootstrappedBit mux(SimulatedCircuitBootstrappedBit a, SimulatedCircuitBootstrappedBit b, SimulatedCircuitBootstrappedBit c) {
-    SimulatedCircuitBootstrappedBit d;
+// Carry-save reduction of bit columns down to two rows. Wallace compresses every column as
+// far as possible at each stage, Dadda only as far as the next height in 2, 3, 4, 6, 9, ...
+// requires. Carries out of the top column are dropped.
+template <class BoolType>
+void CompressColumns(std::vector<std::vector<FoldedBit<BoolType> > > &columns, MultiplierType type) {
+    int width = columns.size();
+    size_t height = 0;
 
-    d.value = a.value ? b.value : c.value;
+    for (int i = 0; i < width; i++)
+        height = std::max(height, columns[i].size());
 
-    if(std::max(a.level, b.level) + 1 > d.routine -> GetBootstrapping()) {
-        d.routine -> Bootstrap();
-    }
+    std::vector<size_t> targets(1, 2);
+    while (targets.back() < height)
+        targets.push_back(targets.back() * 3 / 2);
 
-    if(std::max(a.level, c.level) + 1 > d.routine -> GetBootstrapping()) {
-        d.routine -> Bootstrap();
+    while (height > 2)
+    {
+        FoldedBit<BoolType> sum, carry;
+
+        if (type == MultiplierType::Dadda)
+        {
+            targets.pop_back();
+            size_t target = targets.back();
+
+            for (int i = 0; i < width; i++)
+            {
+                std::vector<FoldedBit<BoolType> > column;
+                size_t k = 0, columnHeight = columns[i].size();
+
+                while (columnHeight > target)
+                {
+                    if (columnHeight == target + 1)
+                    {
+                        HalfAdder(columns[i][k], columns[i][k + 1], sum, carry);
+                        k += 2;
+                        columnHeight -= 1;
+                    }
+                    else
+                    {
+                        FullAdder(columns[i][k], columns[i][k + 1], columns[i][k + 2], sum, carry);
+                        k += 3;
+                        columnHeight -= 2;
+                    }
+
+                    column.push_back(sum);
+                    if (i + 1 < width)
+                        columns[i + 1].push_back(carry);
+                }
+
+                column.insert(column.end(), columns[i].begin() + k, columns[i].end());
+                columns[i] = column;
+            }
+        }
+        else
+        {
+            std::vector<std::vector<FoldedBit<BoolType> > > next(width);
+
+            for (int i = 0; i < width; i++)
+            {
+                size_t k = 0;
+
+                for (; k + 3 <= columns[i].size(); k += 3)
+                {
+                    FullAdder(columns[i][k], columns[i][k + 1], columns[i][k + 2], sum, carry);
+                    next[i].push_back(sum);
+                    if (i + 1 < width)
+                        next[i + 1].push_back(carry);
+                }
+
+                if (k + 2 == columns[i].size())
+                {
+                    HalfAdder(columns[i][k], columns[i][k + 1], sum, carry);
+                    next[i].push_back(sum);
+                    if (i + 1 < width)
+                        next[i + 1].push_back(carry);
+                }
+                else if (k + 1 == columns[i].size())
+                    next[i].push_back(columns[i][k]);
+            }
+
+            columns = next;
+        }
+
+        height = 0;
+        for (int i = 0; i < width; i++)
+            height = std::max(height, columns[i].size());
     }
+}
 
-    d.level = std::max(std::max(a.level, b.level), c.level) + 1;
+// Carry-save reduction followed by one carry-propagate addition of the two rows left
+template <class BoolType>
+std::vector<FoldedBit<BoolType> > ReduceColumns(std::vector<std::vector<FoldedBit<BoolType> > > columns, MultiplierType type, AdderType adder) {
+    int width = columns.size();
 
-    return d;
-}
+    CompressColumns(columns, type);
 
-void SimulatedLevelledBit::Initialize(long long newDepth, Computation &newComputation) {
-    depth = newDepth;
-    routine = &newComputation;
-    routine->Encrypt();
+    std::vector<FoldedBit<BoolType> > first(width, FoldedBit<BoolType>::Constant(0)), second(width, FoldedBit<BoolType>::Constant(0));
+    for (int i = 0; i < width; i++)
+    {
+        if (columns[i].size() > 0)
+            first[i] = columns[i][0];
+        if (columns[i].size() > 1)
+            second[i] = columns[i][1];
+    }
+
+    return AddBits(first, second, FoldedBit<BoolType>::Constant(0), adder);
 }
 
-void SimulatedLevelledBit::Initialize(bool n, long long newDepth, Computation &newComputation) {
-    value = n;
-    depth = newDepth;
-    routine = &newComputation;
-    routine->Encrypt();
+// Karatsuba recursion on half-words. With x = x1 2^h + x0 and y = y1 2^h + y0 the middle
+// term x0 y1 + x1 y0 is (x0 + x1)(y0 + y1) - x0 y0 - x1 y1, which pays off only when the
+// high product x1 y1 reaches the kept bits; otherwise the two cross products are truncated
+// to width - h bits and computed directly. Short operands fall back to a Dadda tree.
+template <class Bits>
+std::vector<typename Bits::value_type> KaratsubaBits(const Bits &a, const Bits &b, int width, AdderType adder) {
+    typedef typename Bits::value_type::BitType BoolType;
+    int n = std::max(a.size(), b.size());
+
+    if (n <= 8 || width <= n / 2)
+        return ReduceColumns(PartialProducts(a, b, width), MultiplierType::Dadda, adder);
+
+    int h = n / 2;
+    std::vector<FoldedBit<BoolType> > a0 = SliceBits(a, 0, h), a1 = SliceBits(a, h, n - h);
+    std::vector<FoldedBit<BoolType> > b0 = SliceBits(b, 0, h), b1 = SliceBits(b, h, n - h);
+    std::vector<FoldedBit<BoolType> > low = KaratsubaBits(a0, b0, std::min(width, 2 * h), adder), middle;
+    int middleWidth = width - h;
+
+    if (width <= 2 * h)
+    {
+        middle = AddBits(KaratsubaBits(a0, b1, middleWidth, adder), KaratsubaBits(a1, b0, middleWidth, adder),
+                         FoldedBit<BoolType>::Constant(0), adder);
+    }
+    else
+    {
+        std::vector<FoldedBit<BoolType> > high = KaratsubaBits(a1, b1, std::min(middleWidth, 2 * (n - h)), adder);
+        std::vector<FoldedBit<BoolType> > a01 = AddBits(SliceBits(a0, 0, n - h + 1), SliceBits(a1, 0, n - h + 1), FoldedBit<BoolType>::Constant(0), adder);
+        std::vector<FoldedBit<BoolType> > b01 = AddBits(SliceBits(b0, 0, n - h + 1), SliceBits(b1, 0, n - h + 1), FoldedBit<BoolType>::Constant(0), adder);
+
+        middle = KaratsubaBits(a01, b01, middleWidth, adder);
+        middle = SubtractBits(middle, SliceBits(low, 0, middleWidth), adder);
+        middle = SubtractBits(middle, SliceBits(high, 0, middleWidth), adder);
+        middle = AddBits(middle, SliceBits(high, -h, middleWidth), FoldedBit<BoolType>::Constant(0), adder);
+    }
+
+    return AddBits(SliceBits(low, 0, width), SliceBits(middle, -h, width), FoldedBit<BoolType>::Constant(0), adder);
 }
 
-SimulatedLevelledBit SimulatedLevelledBit::operator&(const SimulatedLevelledBit &a) const {
-    SimulatedLevelledBit b;
+// Low width bits of a * b. Every variant is truncated: partial products and carries
+// that only reach bits at or above width are never built.
+template <class Bits>
+std::vector<typename Bits::value_type> MultiplyBits(const Bits &a, const Bits &b, int width, MultiplierType type, AdderType adder) {
+    typedef typename Bits::value_type::BitType BoolType;
 
-    b.value = value & a.value;
-    b.routine = routine;
-    b.level = std::max(level, a.level) + 1;
-    b.depth = depth;
+    switch (type)
+    {
+        case MultiplierType::Array:
+        {
+            // One carry-propagate addition per row of the shift-and-add schoolbook method
+            std::vector<FoldedBit<BoolType> > result(width, FoldedBit<BoolType>::Constant(0)), row(width);
+
+            for (int i = 0; i < (int)b.size() && i < width; i++)
+            {
+                for (int j = 0; j < width; j++)
+                    row[j] = (j >= i && j - i < (int)a.size()) ? FoldedAnd(a[j - i], b[i]) : FoldedBit<BoolType>::Constant(0);
+
+                result = i == 0 ? row : AddBits(row, result, FoldedBit<BoolType>::Constant(0), adder);
+            }
+
+            return result;
+        }
+        case MultiplierType::Wallace:
+        case MultiplierType::Dadda:
+            return ReduceColumns(PartialProducts(a, b, width), type, adder);
+        case MultiplierType::Karatsuba:
+            return KaratsubaBits(a, b, width, adder);
+    }
+
+    return std::vector<FoldedBit<BoolType> >(width, FoldedBit<BoolType>::Constant(0));
+}
 
-    if (b.depth < b.level)
+// Greater-than and equality of the bits [low, high) of a and b, split into a balanced
+// tree so that the depth grows with the logarithm of the width. The more significant
+// half decides unless it is equal, so only its equality feeds the greater-than result;
+// outputs that are not asked for are never built.
+template <class ABits, class BBits, class BoolType>
+void CompareBits(const ABits &a, const BBits &b, int low, int high, bool needGreater, bool needEqual, FoldedBit<BoolType> &greater, FoldedBit<BoolType> &equal) {
+    if (high - low == 1)
     {
-        b.level = 0;
-        routine->Bootstrap();
+        if (needGreater)
+            greater = FoldedAnd(a[low], FoldedNot(b[low]));
+        if (needEqual)
+            equal = FoldedNot(FoldedXor(a[low], b[low]));
+        return;
     }
 
-    return b;
+    int middle = low + (high - low) / 2;
+    bool singleHigh = (high - middle == 1);
+    FoldedBit<BoolType> greaterHigh, equalHigh, greaterLow, equalLow;
+
+    CompareBits(a, b, middle, high, needGreater && !singleHigh, needGreater || needEqual, greaterHigh, equalHigh);
+    CompareBits(a, b, low, middle, needGreater, needEqual, greaterLow, equalLow);
+
+    // A single high bit is only consulted when it differs from b, and then it is the answer
+    if (needGreater)
+        greater = FoldedMux(equalHigh, greaterLow, singleHigh ? a[middle] : greaterHigh);
+    if (needEqual)
+        equal = FoldedAnd(equalHigh, equalLow);
 }
 
-SimulatedLevelledBit SimulatedLevelledBit::operator^(const SimulatedLevelledBit &a) const {
-    SimulatedLevelledBit b;
+// Non-restoring division of unsigned a by b. The partial remainder is kept in two's
+// complement on one more bit than the operands, and each step adds or subtracts the
+// divisor depending on its sign, so every quotient bit costs a single addition instead
+// of a comparison and a subtraction. Dividing by zero gives a quotient of all ones and
+// the dividend as remainder, without any extra gates.
+template <class ABits, class BBits, class BoolType>
+void DivideBits(const ABits &a, const BBits &b, std::vector<FoldedBit<BoolType> > &quotient, std::vector<FoldedBit<BoolType> > *remainder, AdderType adder) {
+    int n = a.size();
+    std::vector<FoldedBit<BoolType> > partial(n + 1, FoldedBit<BoolType>::Constant(0)), shifted(n + 1), addend(n + 1);
+    std::vector<FoldedBit<BoolType> > divisor = SliceBits(b, 0, n + 1);
 
-    b.value = value ^ a.value;
-    b.routine = routine;
-    b.level = std::max(level, a.level) + 1;
-    b.depth = depth;
+    quotient.assign(n, FoldedBit<BoolType>::Constant(0));
 
-    if (b.depth < b.level)
+    for (int i = n - 1; i >= 0; i--)
     {
-        b.level = 0;
-        routine->Bootstrap();
-    }
+        // Subtract while the partial remainder is non-negative, add it back otherwise
+        FoldedBit<BoolType> subtract = FoldedNot(partial[n]);
 
-    return b;
-}
+        shifted[0] = a[i];
+        for (int j = 1; j <= n; j++)
+            shifted[j] = partial[j - 1];
 
-SimulatedLevelledBit SimulatedLevelledBit::operator|(const SimulatedLevelledBit &a) const {
-    SimulatedLevelledBit b;
+        for (int j = 0; j <= n; j++)
+            addend[j] = FoldedXor(divisor[j], subtract);
 
-    b.value = value | a.value;
-    b.routine = routine;
-    b.level = std::max(level, a.level) + 1;
-    b.depth = depth;
+        partial = AddBits(shifted, addend, subtract, adder);
+        quotient[i] = FoldedNot(partial[n]);
+    }
 
-    if (b.depth < b.level)
+    if (remainder != NULL)
     {
-        b.level = 0;
-        routine->Bootstrap();
+        std::vector<FoldedBit<BoolType> > correction(n);
+
+        for (int j = 0; j < n; j++)
+            correction[j] = FoldedAnd(divisor[j], partial[n]);
+
+        *remainder = AddBits(SliceBits(partial, 0, n), correction, FoldedBit<BoolType>::Constant(0), adder);
     }
+}
 
-    return b;
+// Bit i of the two's complement representation of n
+bool IntegerBit(long long n, int i) {
+    if (i >= 64)
+        return n < 0;
+
+    return (n >> i) & 1;
 }
 
-SimulatedLevelledBit SimulatedLevelledBit::operator!() const {
-    SimulatedLevelledBit b;
+template <int N, class BoolType>
+std::array<FoldedBit<BoolType>, N> ConstantBits(long long n) {
+    std::array<FoldedBit<BoolType>, N> bits;
 
-    b.value = !value;
-    b.routine = routine;
-    b.depth = depth;
-    b.level = level;
+    for (int i = 0; i < N; i++)
+        bits[i] = FoldedBit<BoolType>::Constant(IntegerBit(n, i));
 
-    return b;
+    return bits;
 }
 
-bool mux(bool a, bool b, bool c) {
-    bool d;
+// a * n mod 2^width as shifted additions and subtractions of a, one per non-zero digit of
+// the non-adjacent form of n, so a run of ones such as 7 = 8 - 1 costs one subtraction.
+// Additions go first, so the first term is plain rewiring.
+template <class Bits>
+std::vector<typename Bits::value_type> MultiplyConstantBits(const Bits &a, long long n, int width, AdderType adder) {
+    typedef typename Bits::value_type::BitType BoolType;
+    std::vector<FoldedBit<BoolType> > result(width, FoldedBit<BoolType>::Constant(0));
+    std::vector<int> added, subtracted;
+    unsigned long long k = n;
+
+    for (int i = 0; i < width && k != 0; i++, k >>= 1)
+    {
+        if (k % 4 == 1)
+        {
+            added.push_back(i);
+            k -= 1;
+        }
+        else if (k % 4 == 3)
+        {
+            subtracted.push_back(i);
+            k += 1;
+        }
+    }
 
-    d = a ? b : c;
+    for (size_t i = 0; i < added.size(); i++)
+        result = AddBits(result, SliceBits(a, -added[i], width), FoldedBit<BoolType>::Constant(0), adder);
 
-    return d;
+    for (size_t i = 0; i < subtracted.size(); i++)
+        result = SubtractBits(result, SliceBits(a, -subtracted[i], width), adder);
+
+    return result;
 }
 
-template <class BoolType>
-GenericInt32<BoolType>::GenericInt32() {
-    for (int i = 0; i < 32; i++)
+template <int N, class BoolType>
+GenericInt<N, BoolType>::GenericInt() : encValue() {
+    adder = AdderPolicy<BoolType>::type;
+    multiplier = MultiplierPolicy<BoolType>::type;
+}
+
+template <int N, class BoolType>
+GenericInt<N, BoolType>::GenericInt(long long n) {
+    adder = AdderPolicy<BoolType>::type;
+    multiplier = MultiplierPolicy<BoolType>::type;
+    for (int i = 0; i < N; i++)
+        encValue[i] = BoolType(IntegerBit(n, i));
+}
+
+template <int N, class BoolType>
+void GenericInt<N, BoolType>::Initialize(Computation &newComputation) {
+    for (int i = 0; i < N; i++)
     {
-        BoolType a(0);
-        encValue.push_back(a);
+        encValue[i].Initialize(newComputation);
     }
 }
 
-template <class BoolType>
-GenericInt32<BoolType>::GenericInt32(int n) {
-    for (int i = 0; i < 32; i++)
+template <int N, class BoolType>
+void GenericInt<N, BoolType>::Initialize(long long n, Computation &newComputation) {
+    for (int i = 0; i < N; i++)
     {
-        BoolType a(n % 2);
-        encValue.push_back(a);
-        n /= 2;
+        encValue[i].Initialize(IntegerBit(n, i), newComputation);
     }
 }
 
-template <class BoolType>
-void GenericInt32<BoolType>::Initialize(Computation &newComputation) {
-    for (int i = 0; i < 32; i++)
+template <int N, class BoolType>
+void GenericInt<N, BoolType>::Initialize(long long n, int newDepth, Computation &newComputation) {
+    for (int i = 0; i < N; i++)
     {
-        encValue[i].Initialize(newComputation);
+        encValue[i].Initialize(IntegerBit(n, i), newDepth, newComputation);
     }
 }
 
-template <class BoolType>
-void GenericInt32<BoolType>::Initialize(int n, Computation &newComputation) {
-    for (int i = 0; i < 32; i++)
+template <int N, class BoolType>
+void GenericInt<N, BoolType>::Initialize(FheContext &newContext) {
+    for (int i = 0; i < N; i++)
     {
-        encValue[i].Initialize(n % 2, newComputation);
-        n /= 2;
+        encValue[i].Initialize(newContext);
     }
 }
 
-template <class BoolType>
-void GenericInt32<BoolType>::Initialize(int n, int newDepth, Computation &newComputation) {
-    for (int i = 0; i < 32; i++)
+template <int N, class BoolType>
+void GenericInt<N, BoolType>::Initialize(long long n, FheContext &newContext) {
+    for (int i = 0; i < N; i++)
     {
-        encValue[i].Initialize(n % 2, newDepth, newComputation);
-        n /= 2;
+        encValue[i].Initialize(IntegerBit(n, i), newContext);
     }
 }
 
-template <class BoolType>
-BoolType GenericInt32<BoolType>::operator==(const GenericInt32<BoolType> &a) const {
-    BoolType ans(0), temp(0);
-
-    for (int i = 0; i < 32; i++)
+template <int N, class BoolType>
+void GenericInt<N, BoolType>::Initialize(Circuit &newCircuit) {
+    for (int i = 0; i < N; i++)
     {
-        temp = !(encValue[i] ^ a.encValue[i]);
+        encValue[i].Initialize(newCircuit);
+    }
+}
 
-        if (i != 0)
-            ans = temp & ans;
-        else
-            ans = temp;
+template <int N, class BoolType>
+void GenericInt<N, BoolType>::Initialize(long long n, Circuit &newCircuit) {
+    for (int i = 0; i < N; i++)
+    {
+        encValue[i].Initialize(IntegerBit(n, i), newCircuit);
     }
+}
+
+template <int N, class BoolType>
+std::array<FoldedBit<BoolType>, N> GenericInt<N, BoolType>::GetFoldedBits() const {
+    std::array<FoldedBit<BoolType>, N> bits;
+
+    for (int i = 0; i < N; i++)
+        bits[i] = FoldedBit<BoolType>::Wire(encValue[i]);
 
-    return ans;
+    return bits;
 }
 
-template <class BoolType>
-BoolType GenericInt32<BoolType>::operator>(const GenericInt32<BoolType> &a) const {
-    BoolType ans(0), temp(0);
-    ans = encValue[0] & ans;
-    temp = encValue[0] & temp;
+template <int N, class BoolType>
+template <class Bits>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::FromFoldedBits(const Bits &bits) const {
+    GenericInt<N, BoolType> result;
+    result.adder = adder;
+    result.multiplier = multiplier;
 
-    for (int i = 0; i < 32; i++)
-    {
-        temp = !(encValue[i] ^ a.encValue[i]);
+    for (int i = 0; i < N; i++)
+        result.encValue[i] = FoldedValue(bits[i]);
 
-        ans = mux(temp, ans, encValue[i]);
-    }
+    return result;
+}
+
+template <int N, class BoolType>
+template <int M>
+GenericInt<M, BoolType> GenericInt<N, BoolType>::ZeroExtend() const {
+    GenericInt<M, BoolType> result;
+    result.adder = adder;
+    result.multiplier = multiplier;
+
+    for (int i = 0; i < M && i < N; i++)
+        result.encValue[i] = encValue[i];
+
+    return result;
+}
+
+template <int N, class BoolType>
+template <int M>
+GenericInt<M, BoolType> GenericInt<N, BoolType>::SignExtend() const {
+    GenericInt<M, BoolType> result = ZeroExtend<M>();
+
+    for (int i = N; i < M; i++)
+        result.encValue[i] = encValue[N - 1];
 
-    return ans;
+    return result;
 }
 
-template <class BoolType>
-BoolType GenericInt32<BoolType>::operator<(const GenericInt32<BoolType> &a) const {
-    BoolType ans(0), temp(0);
-    ans = encValue[0] & ans;
-    temp = encValue[0] & temp;
+template <int N, class BoolType>
+template <int M>
+GenericInt<M, BoolType> GenericInt<N, BoolType>::Truncate() const {
+    static_assert(M <= N, "Truncate cannot widen, use ZeroExtend or SignExtend");
 
-    for (int i = 0; i < 32; i++)
-    {
-        temp = !(encValue[i] ^ a.encValue[i]);
+    return ZeroExtend<M>();
+}
 
-        ans = mux(temp, ans, encValue[i]);
-    }
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator==(const GenericInt<N, BoolType> &a) const {
+    FoldedBit<BoolType> greater, equal;
 
-    return !ans;
+    CompareBits(GetFoldedBits(), a.GetFoldedBits(), 0, N, false, true, greater, equal);
+    return FoldedValue(equal);
 }
 
-template <class BoolType>
-GenericInt32<BoolType> GenericInt32<BoolType>::operator~() const {
-    GenericInt32<BoolType> result;
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator!=(const GenericInt<N, BoolType> &a) const {
+    return !(*this == a);
+}
+
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator>(const GenericInt<N, BoolType> &a) const {
+    FoldedBit<BoolType> greater, equal;
+
+    CompareBits(GetFoldedBits(), a.GetFoldedBits(), 0, N, true, false, greater, equal);
+    return FoldedValue(greater);
+}
+
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator<(const GenericInt<N, BoolType> &a) const {
+    return a > *this;
+}
 
-    for (int i = 0; i < 32; i++)
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator>=(const GenericInt<N, BoolType> &a) const {
+    return !(a > *this);
+}
+
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator<=(const GenericInt<N, BoolType> &a) const {
+    return !(*this > a);
+}
+
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator~() const {
+    GenericInt<N, BoolType> result;
+
+    for (int i = 0; i < N; i++)
         result.encValue[i] = !encValue[i];
 
     return result;
 }
 
-template <class BoolType>
-GenericInt32<BoolType> GenericInt32<BoolType>::operator&(const GenericInt32<BoolType> &a) const {
-    GenericInt32<BoolType> result;
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator&(const GenericInt<N, BoolType> &a) const {
+    GenericInt<N, BoolType> result;
 
-    for (int i = 0; i < 32; i++)
+    for (int i = 0; i < N; i++)
         result.encValue[i] = encValue[i] & a.encValue[i];
 
     return result;
 }
 
-template <class BoolType>
-GenericInt32<BoolType> GenericInt32<BoolType>::operator|(const GenericInt32<BoolType> &a) const {
-    GenericInt32<BoolType> result;
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator|(const GenericInt<N, BoolType> &a) const {
+    GenericInt<N, BoolType> result;
 
-    for (int i = 0; i < 32; i++)
+    for (int i = 0; i < N; i++)
         result.encValue[i] = encValue[i] | a.encValue[i];
 
     return result;
 }
 
-template <class BoolType>
-GenericInt32<BoolType> GenericInt32<BoolType>::operator^(const GenericInt32<BoolType> &a) const {
-    GenericInt32<BoolType> result;
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator^(const GenericInt<N, BoolType> &a) const {
+    GenericInt<N, BoolType> result;
 
-    for (int i = 0; i < 32; i++)
+    for (int i = 0; i < N; i++)
         result.encValue[i] = encValue[i] ^ a.encValue[i];
 
     return result;
 }
 
-template <class BoolType>
-GenericInt32<BoolType> GenericInt32<BoolType>::operator+(const BoolType &a) const {
-    BoolType carry;
-
-    carry = a;
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator+(const BoolType &a) const {
+    return Add(ConstantBits<N, BoolType>(0), FoldedBit<BoolType>::Wire(a));
+}
 
-    GenericInt32<BoolType> result;
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator+(const GenericInt<N, BoolType> &a) const {
+    return Add(a.GetFoldedBits(), FoldedBit<BoolType>::Constant(0));
+}
 
-    for (int i = 0; i < 32; i++)
-    {
-        result.encValue[i] = encValue[i] ^ carry;
-        carry = encValue[i] & carry;
-    }
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator++(int) const {
+    return Add(ConstantBits<N, BoolType>(0), FoldedBit<BoolType>::Constant(1));
+}
 
-    return result;
+// The complement of a stays folded, so the adder reads it through XNOR and ANDYN gates
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator-(const GenericInt<N, BoolType> &a) const {
+    return FromFoldedBits(SubtractBits(GetFoldedBits(), a.GetFoldedBits(), adder));
 }
 
-template <class BoolType>
-GenericInt32<BoolType> GenericInt32<BoolType>::operator+(const GenericInt32<BoolType> &a) const {
-    BoolType carry(0), temp(0);
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator==(long long a) const {
+    FoldedBit<BoolType> greater, equal;
 
-    GenericInt32<BoolType> result;
+    CompareBits(GetFoldedBits(), ConstantBits<N, BoolType>(a), 0, N, false, true, greater, equal);
+    return FoldedValue(equal);
+}
 
-    for (int i = 0; i < 32; i++)
-    {
-        temp = encValue[i] ^ a.encValue[i];
-        result.encValue[i] = temp ^ carry;
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator!=(long long a) const {
+    return !(*this == a);
+}
 
-        carry = (encValue[i] & a.encValue[i]) | (temp & carry);
-    }
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator>(long long a) const {
+    FoldedBit<BoolType> greater, equal;
 
-    return result;
+    CompareBits(GetFoldedBits(), ConstantBits<N, BoolType>(a), 0, N, true, false, greater, equal);
+    return FoldedValue(greater);
 }
 
-template <class BoolType>
-GenericInt32<BoolType> GenericInt32<BoolType>::operator++(int) const {
-    BoolType carry(1);
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator<(long long a) const {
+    FoldedBit<BoolType> greater, equal;
 
-    GenericInt32<BoolType> result;
+    CompareBits(ConstantBits<N, BoolType>(a), GetFoldedBits(), 0, N, true, false, greater, equal);
+    return FoldedValue(greater);
+}
 
-    for (int i = 0; i < 32; i++)
-    {
-        result.encValue[i] = encValue[i] ^ carry;
-        carry = encValue[i] & carry;
-    }
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator>=(long long a) const {
+    return !(*this < a);
+}
 
-    return result;
+template <int N, class BoolType>
+BoolType GenericInt<N, BoolType>::operator<=(long long a) const {
+    return !(*this > a);
 }
 
-template <class BoolType>
-GenericInt32<BoolType> GenericInt32<BoolType>::operator-(const GenericInt32<BoolType> &a) const {
-    GenericInt32<BoolType> result;
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator&(long long a) const {
+    std::array<FoldedBit<BoolType>, N> bits = GetFoldedBits(), constant = ConstantBits<N, BoolType>(a);
 
-    result = ~a;
-    result = result++;
-    result = result + *this;
+    for (int i = 0; i < N; i++)
+        bits[i] = FoldedAnd(bits[i], constant[i]);
 
-    return result;
+    return FromFoldedBits(bits);
 }
 
-template <class BoolType>
-GenericInt32<BoolType> GenericInt32<BoolType>::operator*(const GenericInt32<BoolType> &a) const {
-    BoolType def(0);
-    def = encValue[0] & def;
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator|(long long a) const {
+    std::array<FoldedBit<BoolType>, N> bits = GetFoldedBits(), constant = ConstantBits<N, BoolType>(a);
 
-    GenericInt32<BoolType> result, temp;
+    for (int i = 0; i < N; i++)
+        bits[i] = FoldedOr(bits[i], constant[i]);
 
-    for (int i = 0; i < 32; i++)
-    {
-        for (int j = 31; j >= 0; j--)
-            if (j >= i)
-                temp.encValue[j] = encValue[j - i] & a.encValue[i];
-            else
-                temp.encValue[j] = def;
+    return FromFoldedBits(bits);
+}
 
-        result = temp + result;
-    }
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator^(long long a) const {
+    std::array<FoldedBit<BoolType>, N> bits = GetFoldedBits(), constant = ConstantBits<N, BoolType>(a);
 
-    return result;
+    for (int i = 0; i < N; i++)
+        bits[i] = FoldedXor(bits[i], constant[i]);
+
+    return FromFoldedBits(bits);
 }
 
-template <class BoolType>
-GenericInt32<BoolType> GenericInt32<BoolType>::operator/(const GenericInt32<BoolType> &a) const {
-    BoolType def(0), max(0), one(1);
-    def = encValue[0] & def;
-    one = encValue[0] | one;
+template <int N, class BoolType>
+template <class IntType, class>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator+(IntType a) const {
+    return Add(ConstantBits<N, BoolType>(a), FoldedBit<BoolType>::Constant(0));
+}
+
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator-(long long a) const {
+    return Add(ConstantBits<N, BoolType>(~a), FoldedBit<BoolType>::Constant(1));
+}
 
-    GenericInt32<BoolType> result, divident, temp, zero;
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator*(long long a) const {
+    return FromFoldedBits(MultiplyConstantBits(GetFoldedBits(), a, N, adder));
+}
 
-    for (int i = 0; i < 32; i++)
-        divident.encValue[i] = encValue[i];
+// Division by a power of two is a shift; any other constant still folds its bits into
+// the divisor of the division circuit
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator/(long long a) const {
+    std::vector<FoldedBit<BoolType> > quotient;
+    unsigned long long divisor = N < 64 ? (unsigned long long)a & ((1ULL << (N % 64)) - 1) : a;
 
-    for (int i = 31; i >= 0; i--)
+    if (divisor != 0 && (divisor & (divisor - 1)) == 0)
     {
-        for (int j = 31; j >= 0; j--)
-            if (j >= i)
-                temp.encValue[j] = a.encValue[j - i];
-            else
-                temp.encValue[j] = def;
-
-        max = temp > zero;
-        for (int j = 0; j < 32; j++)
-            temp.encValue[j] = mux(max, temp.encValue[j], one);
+        int shift = 0;
 
-        max = (divident > temp) | (divident == temp);
-        for (int j = 0; j < 32; j++)
-            temp.encValue[j] = temp.encValue[j] & max;
+        while ((divisor >> shift) != 1)
+            shift++;
 
-        divident = divident - temp;
-        result.encValue[i] = max;
+        return FromFoldedBits(SliceBits(GetFoldedBits(), shift, N));
     }
 
-    return result;
+    DivideBits(GetFoldedBits(), ConstantBits<N, BoolType>(a), quotient, (std::vector<FoldedBit<BoolType> >*) NULL, adder);
+    return FromFoldedBits(quotient);
 }
 
-template <class BoolType>
-GenericInt32<BoolType> GenericInt32<BoolType>::operator%(const GenericInt32<BoolType> &a) const {
-    BoolType def(0), max(0), one(1);
-    def = encValue[0] & def;
-    one = encValue[0] | one;
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator%(long long a) const {
+    std::vector<FoldedBit<BoolType> > quotient, remainder;
+    unsigned long long divisor = N < 64 ? (unsigned long long)a & ((1ULL << (N % 64)) - 1) : a;
 
-    GenericInt32<BoolType> result, divident, temp, zero;
+    if (divisor != 0 && (divisor & (divisor - 1)) == 0)
+        return *this & (long long)(divisor - 1);
 
-    for (int i = 0; i < 32; i++)
-        divident.encValue[i] = encValue[i];
+    DivideBits(GetFoldedBits(), ConstantBits<N, BoolType>(a), quotient, &remainder, adder);
+    return FromFoldedBits(remainder);
+}
 
-    for (int i = 31; i >= 0; i--)
-    {
-        for (int j = 31; j >= 0; j--)
-            if (j >= i)
-                temp.encValue[j] = a.encValue[j - i];
-            else
-                temp.encValue[j] = def;
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::Add(const std::array<FoldedBit<BoolType>, N> &a, const FoldedBit<BoolType> &carry) const {
+    return FromFoldedBits(AddBits(GetFoldedBits(), a, carry, adder));
+}
+
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator*(const GenericInt<N, BoolType> &a) const {
+    return FromFoldedBits(MultiplyBits(GetFoldedBits(), a.GetFoldedBits(), N, multiplier, adder));
+}
 
-        max = temp > zero;
-        for (int j = 0; j < 32; j++)
-            temp.encValue[j] = mux(max, temp.encValue[j], one);
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator/(const GenericInt<N, BoolType> &a) const {
+    std::vector<FoldedBit<BoolType> > quotient;
 
-        max = (divident > temp) | (divident == temp);
-        for (int j = 0; j < 32; j++)
-            temp.encValue[j] = temp.encValue[j] & max;
+    DivideBits(GetFoldedBits(), a.GetFoldedBits(), quotient, (std::vector<FoldedBit<BoolType> >*) NULL, adder);
+    return FromFoldedBits(quotient);
+}
 
-        divident = divident - temp;
-    }
+template <int N, class BoolType>
+GenericInt<N, BoolType> GenericInt<N, BoolType>::operator%(const GenericInt<N, BoolType> &a) const {
+    std::vector<FoldedBit<BoolType> > quotient, remainder;
 
-    return divident;
+    DivideBits(GetFoldedBits(), a.GetFoldedBits(), quotient, &remainder, adder);
+    return FromFoldedBits(remainder);
 }
 
-template <class BoolType>
-GenericInt32<BoolType> min(const GenericInt32<BoolType> &a, const GenericInt32<BoolType> &b) {
+template <int N, class BoolType>
+GenericInt<N, BoolType> min(const GenericInt<N, BoolType> &a, const GenericInt<N, BoolType> &b) {
     BoolType smaller(0);
-    GenericInt32<BoolType> result;
+    GenericInt<N, BoolType> result;
     smaller = a < b;
 
-    for (int i = 0; i < 32; i++) {
+    for (int i = 0; i < N; i++) {
         result.encValue[i] = mux(smaller, a.encValue[i], b.encValue[i]);
     }
 
     return result;
 }
 
-template <class BoolType>
-GenericInt32<BoolType> max(const GenericInt32<BoolType> &a, const GenericInt32<BoolType> &b) {
+template <int N, class BoolType>
+GenericInt<N, BoolType> max(const GenericInt<N, BoolType> &a, const GenericInt<N, BoolType> &b) {
     BoolType smaller(0);
-    GenericInt32<BoolType> result;
+    GenericInt<N, BoolType> result;
     smaller = a < b;
 
-    for (int i = 0; i < 32; i++) {
-        result.encValue[i] = mux(smaller, a.encValue[i], b.encValue[i]);
+    for (int i = 0; i < N; i++) {
+        result.encValue[i] = mux(smaller, b.encValue[i], a.encValue[i]);
+    }
+
+    return result;
+}
+
+// Smaller and larger of a and b from one comparison. With swap = a > b and
+// d = swap & (a ^ b), the outputs are a ^ d and b ^ d, one AND per bit on top of XORs.
+template <int N, class BoolType>
+std::pair<GenericInt<N, BoolType>, GenericInt<N, BoolType> > compareExchange(const GenericInt<N, BoolType> &a, const GenericInt<N, BoolType> &b) {
+    std::array<FoldedBit<BoolType>, N> x = a.GetFoldedBits(), y = b.GetFoldedBits(), low, high;
+    FoldedBit<BoolType> swap, equal;
+
+    CompareBits(x, y, 0, N, true, false, swap, equal);
+
+    for (int i = 0; i < N; i++)
+    {
+        FoldedBit<BoolType> difference = FoldedAnd(swap, FoldedXor(x[i], y[i]));
+
+        low[i] = FoldedXor(x[i], difference);
+        high[i] = FoldedXor(y[i], difference);
+    }
+
+    return std::make_pair(a.FromFoldedBits(low), a.FromFoldedBits(high));
+}
+
+// Quotient and remainder of a / b from a single division circuit
+template <int N, class BoolType>
+std::pair<GenericInt<N, BoolType>, GenericInt<N, BoolType> > divmod(const GenericInt<N, BoolType> &a, const GenericInt<N, BoolType> &b) {
+    std::vector<FoldedBit<BoolType> > quotient, remainder;
+
+    DivideBits(a.GetFoldedBits(), b.GetFoldedBits(), quotient, &remainder, a.adder);
+    return std::make_pair(a.FromFoldedBits(quotient), a.FromFoldedBits(remainder));
+}
+
+// Less, equal and greater of a against b from one shared comparison tree
+template <int N, class BoolType>
+Comparison<BoolType> compare(const GenericInt<N, BoolType> &a, const GenericInt<N, BoolType> &b) {
+    FoldedBit<BoolType> greater, equal;
+    Comparison<BoolType> result;
+
+    CompareBits(a.GetFoldedBits(), b.GetFoldedBits(), 0, N, true, true, greater, equal);
+    result.greater = FoldedValue(greater);
+    result.equal = FoldedValue(equal);
+    result.less = FoldedValue(FoldedNot(FoldedOr(greater, equal)));
+
+    return result;
+}
+
+// Replays the recorded gates on any bit type, so a circuit, optimized or not, can be priced
+// on a simulated backend or evaluated on ciphertexts
+template <class BoolType>
+std::vector<BoolType> Circuit::Execute(const std::vector<BoolType> &inputValues) const {
+    std::vector<BoolType> values(gates.size()), result;
+
+    for (size_t i = 0; i < gates.size(); i++)
+    {
+        const Gate &gate = gates[i];
+
+        switch (gate.type)
+        {
+            case GateType::Input:
+                values[i] = inputValues[gate.input[0]];
+                break;
+            case GateType::Constant:
+                values[i] = BoolType((bool)gate.input[0]);
+                break;
+            case GateType::Not:
+                values[i] = !values[gate.input[0]];
+                break;
+            case GateType::Mux:
+                values[i] = mux(values[gate.input[0]], values[gate.input[1]], values[gate.input[2]]);
+                break;
+            default:
+                values[i] = ApplyGate(OperationOf(gate.type), values[gate.input[0]], values[gate.input[1]]);
+        }
     }
 
+    for (size_t i = 0; i < outputs.size(); i++)
+        result.push_back(values[outputs[i]]);
+
     return result;
-}
\ No newline at end of file
+}
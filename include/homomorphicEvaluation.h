@@ -3,34 +3,190 @@
 
 #include <iostream>
 #include <cmath>
+#include <string>
+#include <sstream>
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <queue>
+#include <map>
+#include <functional>
+#include <type_traits>
+#include <mutex>
+#include <cassert>
 #include <tfhe/tfhe.h>
 #include <tfhe/tfhe_io.h>
+#include "sharedCloudKey.h"
 
 namespace homomorphicEvaluation {
-    //generate a keyset
-    const int minimum_lambda = 110;
-    const TFheGateBootstrappingParameterSet* params = new_default_gate_bootstrapping_parameters(minimum_lambda);
-    //generate a random key
-    TFheGateBootstrappingSecretKeySet* key = new_random_gate_bootstrapping_secret_keyset(params);
+    // The two-input gates are TFHE's; NY and YN negate the first or the second input
+    enum class Operation { And, Or, Xor, Xnor, Nand, Nor, AndNY, AndYN, OrNY, OrYN, Mux, Not, Copy, Encrypt, Decrypt };
+    const int operationKinds = 15;
+
+    // Price of every kind of operation in bootstraps and in seconds, so that the same
+    // counted run can be compared under different schemes
+    struct CostModel {
+        std::string name;
+        double secondsPerBootstrap;
+        double bootstraps[operationKinds];
+        double seconds[operationKinds];
+        CostModel(const std::string& newName, double newSecondsPerBootstrap);
+        void SetBootstraps(Operation operation, double n);
+        static CostModel TfheGate();
+        static CostModel Fhew();
+        static CostModel FreeXor();
+        static bool Calibrated(std::istream& in, int threads, CostModel& model);
+    };
+
+    const char* OperationName(Operation operation);
+    // Copy and Decrypt are only timed by benchmarks/Calibration.cpp: simulated bits have no
+    // ciphertexts to copy or decrypt, so a Computation never counts them and its reports
+    // leave them out
+    bool IsCounted(Operation operation);
+    bool GateOutput(Operation operation, bool a, bool b);
 
     class Computation {
     public:
         long long bootCount, encCount;
-        Computation() { bootCount = 0; encCount = 0; }
+        long long operationCount[operationKinds];
+        Computation();
         void Bootstrap();
         void Encrypt();
+        void Record(Operation operation);
         long long GetBootstrapping();
         long long GetEncryptions();
+        long long GetCount(Operation operation) const;
+        double GetBootstrapping(const CostModel& model) const;
+        double GetTime(const CostModel& model) const;
+        void WriteJson(std::ostream& out, const std::vector<CostModel>& models) const;
+        void WriteCsv(std::ostream& out, const std::vector<CostModel>& models) const;
+        // Level profile, filled only by bit types that track exact levels (ProfiledBit)
+        std::vector<std::array<long long, operationKinds> > levelCounts;
+        void Record(Operation operation, long long level);
+        long long GetDepth() const;
+        long long GetWidth(long long level) const;
+        long long GetPeakWidth() const;
+        double GetAverageWidth() const;
+        double GetMakespan(const CostModel& model, int cores) const;
+        void WriteProfile(std::ostream& out, const CostModel& model, const std::vector<int>& cores) const;
     };
 
-    class RealGateBootstrappedBit {
+    class RecordedBit;
+    template <int N, class BoolType> class GenericInt;
+
+    enum class GateType { Input, Constant, And, Xor, Or, Not, Mux, Xnor, Nand, Nor, AndNY, AndYN, OrNY, OrYN };
+
+    Operation OperationOf(GateType type);
+    GateType GateOf(Operation operation);
+
+    // A single node of a recorded circuit. Operands are indices of earlier gates, so the
+    // gate array is always in topological order; a constant keeps its value in input[0].
+    struct Gate {
+        GateType type;
+        int input[3];
+    };
+
+    class Circuit {
     public:
-        LweSample* value = new_gate_bootstrapping_ciphertext(params);
+        std::vector<Gate> gates;
+        std::vector<int> inputs, outputs;
+        int constants[2];
+        Circuit() { constants[0] = -1; constants[1] = -1; }
+        int AddInput();
+        int AddConstant(bool n);
+        int AddGate(GateType type, int a, int b = -1, int c = -1);
+        void AddOutput(const RecordedBit& a);
+        template <int N> void AddOutput(const GenericInt<N, RecordedBit>& a);
+        long long GetGateCount() const;
+        long long GetGateCount(GateType type) const;
+        long long GetBootstrapping() const;
+        double GetBootstrapping(const CostModel& model) const;
+        double GetTime(const CostModel& model) const;
+        std::vector<long long> GetLevels() const;
+        long long GetDepth() const;
+        std::vector<bool> Evaluate(const std::vector<bool>& inputValues) const;
+        template <class BoolType> std::vector<BoolType> Execute(const std::vector<BoolType>& inputValues) const;
+    };
 
-        RealGateBootstrappedBit() { bootsSymEncrypt(value, 0, key); }
-        RealGateBootstrappedBit(bool n) { bootsSymEncrypt(value, n, key); }
-        void operator=(const RealGateBootstrappedBit& a) const;
+    // Free list of gate-bootstrapping ciphertexts. Released samples are kept for reuse
+    // instead of going back to the allocator, since a long evaluation creates and drops
+    // temporaries at the rate it evaluates gates. Samples handed out and not yet released
+    // are counted as live.
+    class CiphertextArena {
+    public:
+        const TFheGateBootstrappingParameterSet* params;
+        CiphertextArena() { params = NULL; live = 0; }
+        ~CiphertextArena();
+        LweSample* Acquire();
+        void Release(LweSample* sample);
+        void Clear();
+        size_t GetFreeCount();
+        size_t GetLiveCount();
+    private:
+        std::vector<LweSample*> samples;
+        size_t live;
+        std::mutex lock;
+    };
+
+    // Parameters and keys of one TFHE deployment. A client generates or loads the secret
+    // keyset and saves the cloud key; an evaluator loads only the cloud key, so it can run
+    // gates and make trivial encryptions of public bits but cannot decrypt. Evaluators on
+    // one host can instead map a shared cloud key saved with SaveSharedCloudKey. Bits keep
+    // a pointer to their context, which has to outlive them. Generating, loading or mapping
+    // keys frees the pooled samples along with the old keys, so no bit of the context may
+    // be alive then. Decrypt needs the secret key.
+    class FheContext {
+    public:
+        const TFheGateBootstrappingParameterSet* params;
+        TFheGateBootstrappingSecretKeySet* secretKey;
+        const TFheGateBootstrappingCloudKeySet* cloudKey;
+        CiphertextArena arena;
+        FheContext();
+        FheContext(const FheContext&) = delete;
+        FheContext& operator=(const FheContext&) = delete;
+        ~FheContext();
+        void Generate(int minimumLambda = 110);
+        bool LoadSecretKey(const std::string& path);
+        bool LoadCloudKey(const std::string& path);
+        bool SaveSecretKey(const std::string& path) const;
+        bool SaveCloudKey(const std::string& path) const;
+        bool MapCloudKey(const std::string& path);
+        bool SaveSharedCloudKey(const std::string& path) const;
+        bool HasSecretKey() const;
+        void Encrypt(LweSample* sample, bool n);
+        bool Decrypt(const LweSample* sample) const;
+    private:
+        TFheGateBootstrappingParameterSet* ownParams;
+        TFheGateBootstrappingCloudKeySet* ownCloudKey;
+        SharedCloudKey* sharedKey;
+        void Clear();
+    };
+
+    // Tag for output temporaries that are overwritten by a gate before they are read
+    struct Uninitialized {};
+    const Uninitialized uninitialized = {};
+
+    // A bit without a context is a public constant held in plain and has no ciphertext, so
+    // default elements cost nothing and gates against them fold away. A borrowed bit reads
+    // a ciphertext owned elsewhere, such as a mapped dataset record, and never writes it.
+    class RealGateBootstrappedBit {
+    public:
+        LweSample* value;
+        bool plain;
+        bool borrowed;
+        FheContext* context;
+        RealGateBootstrappedBit() { value = NULL; plain = 0; borrowed = false; context = NULL; }
+        RealGateBootstrappedBit(bool n) { value = NULL; plain = n; borrowed = false; context = NULL; }
+        RealGateBootstrappedBit(FheContext& newContext, Uninitialized);
+        RealGateBootstrappedBit(FheContext& newContext, LweSample* sample);
+        RealGateBootstrappedBit(const RealGateBootstrappedBit& a);
+        RealGateBootstrappedBit(RealGateBootstrappedBit&& a) noexcept;
+        ~RealGateBootstrappedBit();
+        RealGateBootstrappedBit& operator=(const RealGateBootstrappedBit& a);
+        RealGateBootstrappedBit& operator=(RealGateBootstrappedBit&& a) noexcept;
+        void Initialize(FheContext& newContext);
+        void Initialize(bool n, FheContext& newContext);
+        bool Decrypt() const;
         RealGateBootstrappedBit operator&(const RealGateBootstrappedBit& a) const;
         RealGateBootstrappedBit operator^(const RealGateBootstrappedBit& a) const;
         RealGateBootstrappedBit operator|(const RealGateBootstrappedBit& a) const;
@@ -41,8 +197,8 @@ namespace homomorphicEvaluation {
     public:
         bool value;
         Computation* routine;
-        SimulatedGateBootstrappedBit() { value = 0; }
-        SimulatedGateBootstrappedBit(bool n) { value = n; }
+        SimulatedGateBootstrappedBit() { value = 0; routine = NULL; }
+        SimulatedGateBootstrappedBit(bool n) { value = n; routine = NULL; }
         void Initialize(Computation& newComputation);
         void Initialize(bool n, Computation& newComputation);
         SimulatedGateBootstrappedBit operator&(const SimulatedGateBootstrappedBit& a) const;
@@ -56,8 +212,8 @@ namespace homomorphicEvaluation {
         bool value;
         long long level;
         Computation* routine;
-        SimulatedCircuitBootstrappedBit() { value = 0; level = 0; }
-        SimulatedCircuitBootstrappedBit(bool n) { value = n; level = 0; }
+        SimulatedCircuitBootstrappedBit() { value = 0; level = 0; routine = NULL; }
+        SimulatedCircuitBootstrappedBit(bool n) { value = n; level = 0; routine = NULL; }
         void Initialize(Computation& newComputation);
         void Initialize(bool n, Computation& newComputation);
         SimulatedCircuitBootstrappedBit operator&(const SimulatedCircuitBootstrappedBit& a) const;
@@ -72,8 +228,8 @@ namespace homomorphicEvaluation {
         long long level;
         long long depth;
         Computation* routine;
-        SimulatedLevelledBit() { value = 0; level = 0; }
-        SimulatedLevelledBit(bool n) { value = n; level = 0; }
+        SimulatedLevelledBit() { value = 0; level = 0; depth = 0; routine = NULL; }
+        SimulatedLevelledBit(bool n) { value = n; level = 0; depth = 0; routine = NULL; }
         void Initialize(long long newDepth, Computation& newComputation);
         void Initialize(bool n, long long newDepth, Computation& newComputation);
         SimulatedLevelledBit operator&(const SimulatedLevelledBit& a) const;
@@ -82,30 +238,137 @@ namespace homomorphicEvaluation {
         SimulatedLevelledBit operator!() const;
     };
 
-    template <class BoolType> class GenericInt32 {
+    // Gate-bootstrapped bit that keeps the exact level of its wire: a gate sits one level
+    // above its deepest operand and a NOT stays on its operand's level. Every gate is
+    // counted at its level in the Computation, which gives the depth, the width of each
+    // level and the makespan on a number of cores.
+    class ProfiledBit {
+    public:
+        bool value;
+        long long level;
+        Computation* routine;
+        ProfiledBit() { value = 0; level = 0; routine = NULL; }
+        ProfiledBit(bool n) { value = n; level = 0; routine = NULL; }
+        void Initialize(Computation& newComputation);
+        void Initialize(bool n, Computation& newComputation);
+        ProfiledBit operator&(const ProfiledBit& a) const;
+        ProfiledBit operator^(const ProfiledBit& a) const;
+        ProfiledBit operator|(const ProfiledBit& a) const;
+        ProfiledBit operator!() const;
+    };
+
+    class RecordedBit {
     public:
-        std::vector<BoolType> encValue;
-        GenericInt32();
-        GenericInt32(int n);
+        bool value;
+        int id;
+        Circuit* circuit;
+        RecordedBit() { value = 0; id = -1; circuit = NULL; }
+        RecordedBit(bool n) { value = n; id = -1; circuit = NULL; }
+        void Initialize(Circuit& newCircuit);
+        void Initialize(bool n, Circuit& newCircuit);
+        RecordedBit operator&(const RecordedBit& a) const;
+        RecordedBit operator^(const RecordedBit& a) const;
+        RecordedBit operator|(const RecordedBit& a) const;
+        RecordedBit operator!() const;
+    };
+
+    enum class AdderType { RippleCarry, KoggeStone, BrentKung, Sklansky };
+
+    // Adder used by new GenericInt values of a given bit type; specialize to change it
+    template <class BoolType> struct AdderPolicy {
+        static const AdderType type = AdderType::RippleCarry;
+    };
+
+    // Array adds one shifted row at a time; Wallace and Dadda reduce all partial products
+    // with carry-save adders first; Karatsuba recurses on half-words
+    enum class MultiplierType { Array, Wallace, Dadda, Karatsuba };
+
+    template <class BoolType> struct MultiplierPolicy {
+        static const MultiplierType type = MultiplierType::Array;
+    };
+
+    // Either a public constant (known is 0 or 1) or a ciphertext (known is -1), so that
+    // circuits can skip the gates whose result is decided at construction time. A negated
+    // wire stands for !bit without having built the NOT: the gate that reads it picks the
+    // TFHE gate with that input inverted, and the NOT is only made if a value is needed.
+    template <class BoolType> struct FoldedBit {
+        typedef BoolType BitType;
+        int known;
+        bool negated;
+        BoolType bit;
+        static FoldedBit<BoolType> Constant(bool n) { FoldedBit<BoolType> a; a.known = n; a.negated = false; return a; }
+        static FoldedBit<BoolType> Wire(const BoolType& n) { FoldedBit<BoolType> a; a.known = -1; a.negated = false; a.bit = n; return a; }
+    };
+
+    template <class BoolType> struct Comparison {
+        BoolType less, equal, greater;
+    };
+
+    // Unsigned N-bit integer over any bit type, least significant bit first
+    template <int N, class BoolType> class GenericInt {
+    public:
+        std::array<BoolType, N> encValue;
+        // Adder and multiplier of the left operand are used by +, -, ++, * and /, and
+        // results inherit them
+        AdderType adder;
+        MultiplierType multiplier;
+        GenericInt();
+        GenericInt(long long n);
         void Initialize(Computation& newComputation);
-        void Initialize(int n, Computation& newComputation);
-        void Initialize(int n, int newDepth, Computation& newComputation);
-        BoolType operator==(const GenericInt32<BoolType>& a) const;
-        BoolType operator>(const GenericInt32<BoolType>& a) const;
-        BoolType operator<(const GenericInt32<BoolType>& a) const;
-        GenericInt32<BoolType> operator~() const;
-        GenericInt32<BoolType> operator&(const GenericInt32<BoolType>& a) const;
-        GenericInt32<BoolType> operator|(const GenericInt32<BoolType>& a) const;
-        GenericInt32<BoolType> operator^(const GenericInt32<BoolType>& a) const;
-        GenericInt32<BoolType> operator+(const BoolType& a) const;
-        GenericInt32<BoolType> operator+(const GenericInt32<BoolType>& a) const;
-        GenericInt32<BoolType> operator++(int) const;
-        GenericInt32<BoolType> operator-(const GenericInt32<BoolType>& a) const;
-        GenericInt32<BoolType> operator*(const GenericInt32<BoolType>& a) const;
-        GenericInt32<BoolType> operator/(const GenericInt32<BoolType>& a) const;
-        GenericInt32<BoolType> operator%(const GenericInt32<BoolType>& a) const;
+        void Initialize(long long n, Computation& newComputation);
+        void Initialize(long long n, int newDepth, Computation& newComputation);
+        void Initialize(Circuit& newCircuit);
+        void Initialize(long long n, Circuit& newCircuit);
+        void Initialize(FheContext& newContext);
+        void Initialize(long long n, FheContext& newContext);
+        template <int M> GenericInt<M, BoolType> ZeroExtend() const;
+        template <int M> GenericInt<M, BoolType> SignExtend() const;
+        template <int M> GenericInt<M, BoolType> Truncate() const;
+        BoolType operator==(const GenericInt<N, BoolType>& a) const;
+        BoolType operator!=(const GenericInt<N, BoolType>& a) const;
+        BoolType operator>(const GenericInt<N, BoolType>& a) const;
+        BoolType operator<(const GenericInt<N, BoolType>& a) const;
+        BoolType operator>=(const GenericInt<N, BoolType>& a) const;
+        BoolType operator<=(const GenericInt<N, BoolType>& a) const;
+        GenericInt<N, BoolType> operator~() const;
+        GenericInt<N, BoolType> operator&(const GenericInt<N, BoolType>& a) const;
+        GenericInt<N, BoolType> operator|(const GenericInt<N, BoolType>& a) const;
+        GenericInt<N, BoolType> operator^(const GenericInt<N, BoolType>& a) const;
+        GenericInt<N, BoolType> operator+(const BoolType& a) const;
+        GenericInt<N, BoolType> operator+(const GenericInt<N, BoolType>& a) const;
+        GenericInt<N, BoolType> operator++(int) const;
+        GenericInt<N, BoolType> operator-(const GenericInt<N, BoolType>& a) const;
+        GenericInt<N, BoolType> operator*(const GenericInt<N, BoolType>& a) const;
+        GenericInt<N, BoolType> operator/(const GenericInt<N, BoolType>& a) const;
+        GenericInt<N, BoolType> operator%(const GenericInt<N, BoolType>& a) const;
+        // Operations with a public constant fold its known bits while the circuit is built
+        BoolType operator==(long long a) const;
+        BoolType operator!=(long long a) const;
+        BoolType operator>(long long a) const;
+        BoolType operator<(long long a) const;
+        BoolType operator>=(long long a) const;
+        BoolType operator<=(long long a) const;
+        GenericInt<N, BoolType> operator&(long long a) const;
+        GenericInt<N, BoolType> operator|(long long a) const;
+        GenericInt<N, BoolType> operator^(long long a) const;
+        // A template so that GenericInt<N, bool> + int does not compete with + BoolType
+        template <class IntType, class = typename std::enable_if<std::is_integral<IntType>::value>::type>
+        GenericInt<N, BoolType> operator+(IntType a) const;
+        GenericInt<N, BoolType> operator-(long long a) const;
+        GenericInt<N, BoolType> operator*(long long a) const;
+        GenericInt<N, BoolType> operator/(long long a) const;
+        GenericInt<N, BoolType> operator%(long long a) const;
+        GenericInt<N, BoolType> Add(const std::array<FoldedBit<BoolType>, N>& a, const FoldedBit<BoolType>& carry) const;
+        std::array<FoldedBit<BoolType>, N> GetFoldedBits() const;
+        // Takes the bits as a std::array or as a std::vector of at least N bits
+        template <class Bits> GenericInt<N, BoolType> FromFoldedBits(const Bits& bits) const;
     };
 
+    template <class BoolType> using GenericInt8 = GenericInt<8, BoolType>;
+    template <class BoolType> using GenericInt16 = GenericInt<16, BoolType>;
+    template <class BoolType> using GenericInt32 = GenericInt<32, BoolType>;
+    template <class BoolType> using GenericInt64 = GenericInt<64, BoolType>;
+
     // homomorphicEvaluation.cpp includes the definitions of all the template classes/functions/methods
     #include "homomorphicEvaluation.cpp"
 };
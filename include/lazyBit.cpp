@@ -0,0 +1,217 @@
+template <class BoolType>
+LazyScheduler<BoolType>::LazyScheduler(WorkStealingPool &newPool, size_t newBatchSize) {
+    pool = &newPool;
+    batchSize = std::max(newBatchSize, (size_t)1);
+    nodeCount = 0;
+    waveCount = 0;
+    batchCount = 0;
+}
+
+template <class BoolType>
+void LazyScheduler<BoolType>::Add(const std::shared_ptr<LazyNode<BoolType> > &node) {
+    bool full;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pending.push_back(node);
+        full = pending.size() >= batchSize;
+    }
+
+    if (full)
+        Flush();
+}
+
+template <class BoolType>
+void EvaluateNode(LazyNode<BoolType> &node) {
+    switch (node.operation)
+    {
+        case Operation::Mux:
+            node.value = mux(node.input[0]->value, node.input[1]->value, node.input[2]->value);
+            break;
+        case Operation::Not:
+            node.value = !node.input[0]->value;
+            break;
+        default:
+            node.value = ApplyGate(node.operation, node.input[0]->value, node.input[1]->value);
+    }
+
+    for (int i = 0; i < 3; i++)
+        node.input[i].reset();
+}
+
+// Pending nodes are added after their inputs, so one pass in order gives every node a
+// level above the pending nodes it reads; ready inputs count as level 0
+template <class BoolType>
+void LazyScheduler<BoolType>::Flush() {
+    std::lock_guard<std::mutex> flushGuard(flushLock);
+    std::vector<std::shared_ptr<LazyNode<BoolType> > > batch;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        batch.swap(pending);
+    }
+
+    if (batch.empty())
+        return;
+
+    std::vector<std::vector<LazyNode<BoolType>*> > waves;
+
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        LazyNode<BoolType> &node = *batch[i];
+
+        node.level = 0;
+        for (int j = 0; j < 3; j++)
+            if (node.input[j] && !node.input[j]->ready)
+                node.level = std::max(node.level, node.input[j]->level + 1);
+
+        if ((long long)waves.size() <= node.level)
+            waves.resize(node.level + 1);
+        waves[node.level].push_back(&node);
+    }
+
+    for (size_t i = 0; i < waves.size(); i++)
+    {
+        for (size_t j = 0; j < waves[i].size(); j++)
+        {
+            LazyNode<BoolType> *node = waves[i][j];
+
+            pool->Submit([node] { EvaluateNode(*node); });
+        }
+        pool->Wait();
+
+        for (size_t j = 0; j < waves[i].size(); j++)
+            waves[i][j]->ready = true;
+    }
+
+    nodeCount += batch.size();
+    waveCount += waves.size();
+    batchCount++;
+}
+
+template <class BoolType>
+size_t LazyScheduler<BoolType>::GetPendingCount() {
+    std::lock_guard<std::mutex> guard(lock);
+
+    return pending.size();
+}
+
+template <class BoolType>
+LazyBit<BoolType>::LazyBit(bool n) {
+    node = std::make_shared<LazyNode<BoolType> >();
+    node->operation = Operation::Copy;
+    node->value = BoolType(n);
+    node->ready = true;
+    node->level = 0;
+    scheduler = NULL;
+}
+
+template <class BoolType>
+LazyBit<BoolType>::LazyBit(const BoolType &n, LazyScheduler<BoolType> &newScheduler) {
+    node = std::make_shared<LazyNode<BoolType> >();
+    node->operation = Operation::Copy;
+    node->value = n;
+    node->ready = true;
+    node->level = 0;
+    scheduler = &newScheduler;
+}
+
+template <class BoolType>
+bool LazyBit<BoolType>::IsReady() const {
+    return node->ready;
+}
+
+template <class BoolType>
+const BoolType &LazyBit<BoolType>::Get() const {
+    if (!node->ready)
+        scheduler->Flush();
+
+    return node->value;
+}
+
+// A gate between ready constants is evaluated at once; anything else becomes a pending
+// node of the first scheduler among the inputs
+template <class BoolType>
+LazyBit<BoolType> MakeLazyGate(Operation operation, const LazyBit<BoolType> &a, const LazyBit<BoolType> &b, const LazyBit<BoolType> &c) {
+    LazyBit<BoolType> d;
+    const LazyBit<BoolType> *inputs[3] = {&a, &b, &c};
+    int count = operation == Operation::Mux ? 3 : (operation == Operation::Not ? 1 : 2);
+
+    d.scheduler = NULL;
+    for (int i = 0; i < count && d.scheduler == NULL; i++)
+        d.scheduler = inputs[i]->scheduler;
+
+    d.node = std::make_shared<LazyNode<BoolType> >();
+    d.node->operation = operation;
+    d.node->ready = false;
+    d.node->level = 0;
+
+    for (int i = 0; i < count; i++)
+        d.node->input[i] = inputs[i]->node;
+
+    if (d.scheduler == NULL)
+    {
+        EvaluateNode(*d.node);
+        d.node->ready = true;
+    }
+    else
+        d.scheduler->Add(d.node);
+
+    return d;
+}
+
+template <class BoolType>
+LazyBit<BoolType> ApplyGate(Operation operation, const LazyBit<BoolType> &a, const LazyBit<BoolType> &b) {
+    return MakeLazyGate(operation, a, b, b);
+}
+
+template <class BoolType>
+LazyBit<BoolType> LazyBit<BoolType>::operator&(const LazyBit<BoolType> &a) const {
+    return MakeLazyGate(Operation::And, *this, a, a);
+}
+
+template <class BoolType>
+LazyBit<BoolType> LazyBit<BoolType>::operator^(const LazyBit<BoolType> &a) const {
+    return MakeLazyGate(Operation::Xor, *this, a, a);
+}
+
+template <class BoolType>
+LazyBit<BoolType> LazyBit<BoolType>::operator|(const LazyBit<BoolType> &a) const {
+    return MakeLazyGate(Operation::Or, *this, a, a);
+}
+
+template <class BoolType>
+LazyBit<BoolType> LazyBit<BoolType>::operator!() const {
+    return MakeLazyGate(Operation::Not, *this, *this, *this);
+}
+
+template <class BoolType>
+LazyBit<BoolType> mux(const LazyBit<BoolType> &a, const LazyBit<BoolType> &b, const LazyBit<BoolType> &c) {
+    return MakeLazyGate(Operation::Mux, a, b, c);
+}
+
+template <int N, class BoolType>
+GenericInt<N, LazyBit<BoolType> > MakeLazy(const GenericInt<N, BoolType> &a, LazyScheduler<BoolType> &scheduler) {
+    GenericInt<N, LazyBit<BoolType> > result;
+
+    result.adder = a.adder;
+    result.multiplier = a.multiplier;
+
+    for (int i = 0; i < N; i++)
+        result.encValue[i] = LazyBit<BoolType>(a.encValue[i], scheduler);
+
+    return result;
+}
+
+template <int N, class BoolType>
+GenericInt<N, BoolType> Resolve(const GenericInt<N, LazyBit<BoolType> > &a) {
+    GenericInt<N, BoolType> result;
+
+    result.adder = a.adder;
+    result.multiplier = a.multiplier;
+
+    for (int i = 0; i < N; i++)
+        result.encValue[i] = a.encValue[i].Get();
+
+    return result;
+}
@@ -0,0 +1,73 @@
+#ifndef HOMOMORPHIC_ENCRYPTION_LAZY_BIT_H
+#define HOMOMORPHIC_ENCRYPTION_LAZY_BIT_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include "homomorphicEvaluation.h"
+#include "parallelExecutor.h"
+
+namespace homomorphicEvaluation {
+    // Gate of a lazy evaluation. A ready node holds its value; a pending one holds its
+    // operation and inputs until its scheduler evaluates it, and then drops the inputs.
+    template <class BoolType> struct LazyNode {
+        Operation operation;
+        std::shared_ptr<LazyNode<BoolType> > input[3];
+        BoolType value;
+        bool ready;
+        long long level;
+    };
+
+    // Collects the pending nodes built by serial code and evaluates them on a pool when a
+    // value is read or batchSize nodes are waiting. A batch runs one dependency level at a
+    // time like ParallelExecutor, so independent gates run concurrently; the gates of
+    // BoolType have to be safe to run from several threads, as bool and
+    // RealGateBootstrappedBit with the spqlios FFT processor are.
+    template <class BoolType> class LazyScheduler {
+    public:
+        LazyScheduler(WorkStealingPool& newPool, size_t newBatchSize = 4096);
+        void Add(const std::shared_ptr<LazyNode<BoolType> >& node);
+        void Flush();
+        size_t GetPendingCount();
+        long long GetNodeCount() const { return nodeCount; }
+        long long GetWaveCount() const { return waveCount; }
+        long long GetBatchCount() const { return batchCount; }
+    private:
+        WorkStealingPool* pool;
+        size_t batchSize;
+        std::vector<std::shared_ptr<LazyNode<BoolType> > > pending;
+        std::mutex lock, flushLock;
+        long long nodeCount, waveCount, batchCount;
+    };
+
+    // Handle to a node: its operators return at once with a pending node, and Get or
+    // Decrypt flushes the scheduler if the value is not there yet. A bit without a
+    // scheduler is a ready constant, and gates between constants are evaluated right away.
+    template <class BoolType> class LazyBit {
+    public:
+        std::shared_ptr<LazyNode<BoolType> > node;
+        LazyScheduler<BoolType>* scheduler;
+        LazyBit() : LazyBit(false) {}
+        LazyBit(bool n);
+        LazyBit(const BoolType& n, LazyScheduler<BoolType>& newScheduler);
+        bool IsReady() const;
+        const BoolType& Get() const;
+        bool Decrypt() const { return Get().Decrypt(); }
+        LazyBit<BoolType> operator&(const LazyBit<BoolType>& a) const;
+        LazyBit<BoolType> operator^(const LazyBit<BoolType>& a) const;
+        LazyBit<BoolType> operator|(const LazyBit<BoolType>& a) const;
+        LazyBit<BoolType> operator!() const;
+    };
+
+    template <class BoolType> struct AdderPolicy<LazyBit<BoolType> > : AdderPolicy<BoolType> {};
+    template <class BoolType> struct MultiplierPolicy<LazyBit<BoolType> > : MultiplierPolicy<BoolType> {};
+
+    // Wraps ready values for a scheduler, and reads the values of lazy ones with one flush
+    template <int N, class BoolType> GenericInt<N, LazyBit<BoolType> > MakeLazy(const GenericInt<N, BoolType>& a, LazyScheduler<BoolType>& scheduler);
+    template <int N, class BoolType> GenericInt<N, BoolType> Resolve(const GenericInt<N, LazyBit<BoolType> >& a);
+
+    // lazyBit.cpp includes the definitions of the scheduler and the lazy gates
+    #include "lazyBit.cpp"
+};
+
+#endif
@@ -0,0 +1,210 @@
+WorkStealingPool::WorkStealingPool(int threadCount) {
+    queued = 0;
+    pending = 0;
+    next = 0;
+    stopping = false;
+
+    if (threadCount < 1)
+        threadCount = 1;
+
+    for (int i = 0; i < threadCount; i++)
+        workers.push_back(std::unique_ptr<Worker>(new Worker()));
+
+    for (int i = 0; i < threadCount; i++)
+        threads.push_back(std::thread(&WorkStealingPool::Run, this, i));
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        stopping = true;
+    }
+
+    wake.notify_all();
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
+void WorkStealingPool::Submit(const std::function<void()> &task) {
+    size_t index;
+
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        index = next;
+        next = (next + 1) % workers.size();
+        pending++;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(workers[index]->lock);
+        workers[index]->tasks.push_back(task);
+    }
+
+    // Counted only once it is in the deque, so a worker woken for it always finds a task
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        queued++;
+    }
+
+    wake.notify_one();
+}
+
+void WorkStealingPool::Wait() {
+    std::unique_lock<std::mutex> guard(stateLock);
+
+    done.wait(guard, [this] { return pending == 0; });
+}
+
+int WorkStealingPool::GetThreadCount() const {
+    return threads.size();
+}
+
+bool WorkStealingPool::Take(size_t index, std::function<void()> &task) {
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        Worker &worker = *workers[(index + i) % workers.size()];
+        std::lock_guard<std::mutex> guard(worker.lock);
+
+        if (worker.tasks.empty())
+            continue;
+
+        if (i == 0)
+        {
+            task = worker.tasks.back();
+            worker.tasks.pop_back();
+        }
+        else
+        {
+            task = worker.tasks.front();
+            worker.tasks.pop_front();
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void WorkStealingPool::Run(size_t index) {
+    std::function<void()> task;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> guard(stateLock);
+
+            wake.wait(guard, [this] { return stopping || queued > 0; });
+            if (queued == 0)
+                return;
+            queued--;
+        }
+
+        Take(index, task);
+
+        task();
+
+        std::lock_guard<std::mutex> guard(stateLock);
+        if (--pending == 0)
+            done.notify_all();
+    }
+}
+
+void ExecuteGate(const Gate &gate, std::vector<LweSample*> &values, int id, const TFheGateBootstrappingCloudKeySet *cloud) {
+    switch (gate.type)
+    {
+        case GateType::Not:
+            bootsNOT(values[id], values[gate.input[0]], cloud);
+            break;
+        case GateType::Mux:
+            bootsMUX(values[id], values[gate.input[0]], values[gate.input[1]], values[gate.input[2]], cloud);
+            break;
+        case GateType::Constant:
+            bootsCONSTANT(values[id], gate.input[0], cloud);
+            break;
+        case GateType::Input:
+            break;
+        default:
+            BootsGate(OperationOf(gate.type), values[id], values[gate.input[0]], values[gate.input[1]], cloud);
+    }
+}
+
+std::vector<RealGateBootstrappedBit> ParallelExecutor::Execute(const Circuit &circuit, const std::vector<RealGateBootstrappedBit> &inputs) {
+    const std::vector<Gate> &gates = circuit.gates;
+    std::vector<long long> levels = circuit.GetLevels();
+    long long depth = 0;
+
+    for (size_t i = 0; i < levels.size(); i++)
+        depth = std::max(depth, levels[i]);
+
+    // Bootstrapped gates of each level run in parallel; NOT gates share the level of their
+    // operand and are cheap, so they are applied serially once their level is complete
+    std::vector<std::vector<int> > waves(depth + 1), negations(depth + 1);
+    for (size_t i = 0; i < gates.size(); i++)
+    {
+        if (gates[i].type == GateType::Input)
+            continue;
+        if (gates[i].type == GateType::Not || gates[i].type == GateType::Constant)
+            negations[levels[i]].push_back(i);
+        else
+            waves[levels[i]].push_back(i);
+    }
+
+    const TFheGateBootstrappingCloudKeySet *cloud = context->cloudKey;
+    LweSample *samples = new_gate_bootstrapping_ciphertext_array(gates.size(), context->params);
+    std::vector<LweSample*> values(gates.size());
+
+    // Public constant inputs have no ciphertext of their own and get a trivial one
+    for (size_t i = 0; i < gates.size(); i++)
+    {
+        const RealGateBootstrappedBit *input = gates[i].type == GateType::Input ? &inputs[gates[i].input[0]] : NULL;
+
+        if (input != NULL && input->value != NULL)
+            values[i] = input->value;
+        else
+            values[i] = samples + i;
+
+        if (input != NULL && input->value == NULL)
+            bootsCONSTANT(values[i], input->plain, cloud);
+    }
+
+    for (long long level = 0; level <= depth; level++)
+    {
+        for (size_t i = 0; i < waves[level].size(); i++)
+        {
+            int id = waves[level][i];
+
+            pool.Submit([&gates, &values, id, cloud] { ExecuteGate(gates[id], values, id, cloud); });
+        }
+        pool.Wait();
+
+        for (size_t i = 0; i < negations[level].size(); i++)
+            ExecuteGate(gates[negations[level][i]], values, negations[level][i], cloud);
+    }
+
+    std::vector<RealGateBootstrappedBit> result;
+    result.reserve(circuit.outputs.size());
+    for (size_t i = 0; i < circuit.outputs.size(); i++)
+    {
+        result.push_back(RealGateBootstrappedBit(*context, uninitialized));
+        bootsCOPY(result[i].value, values[circuit.outputs[i]], cloud);
+    }
+
+    delete_gate_bootstrapping_ciphertext_array(gates.size(), samples);
+    return result;
+}
+
+template <int N>
+void AppendBits(std::vector<RealGateBootstrappedBit> &bits, const GenericInt<N, RealGateBootstrappedBit> &a) {
+    for (int i = 0; i < N; i++)
+        bits.push_back(a.encValue[i]);
+}
+
+template <int N>
+GenericInt<N, RealGateBootstrappedBit> ExtractInt(const std::vector<RealGateBootstrappedBit> &bits, int offset) {
+    GenericInt<N, RealGateBootstrappedBit> result;
+
+    for (int i = 0; i < N; i++)
+        result.encValue[i] = bits[offset + i];
+
+    return result;
+}
@@ -0,0 +1,59 @@
+#ifndef HOMOMORPHIC_ENCRYPTION_PARALLEL_EXECUTOR_H
+#define HOMOMORPHIC_ENCRYPTION_PARALLEL_EXECUTOR_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "homomorphicEvaluation.h"
+
+namespace homomorphicEvaluation {
+    // Fixed set of workers, each with its own task deque. A worker pops from the back of its
+    // own deque and, once that is empty, steals from the front of the others.
+    class WorkStealingPool {
+    public:
+        WorkStealingPool(int threadCount = std::thread::hardware_concurrency());
+        ~WorkStealingPool();
+        void Submit(const std::function<void()>& task);
+        void Wait();
+        int GetThreadCount() const;
+    private:
+        struct Worker {
+            std::deque<std::function<void()> > tasks;
+            std::mutex lock;
+        };
+
+        std::vector<std::unique_ptr<Worker> > workers;
+        std::vector<std::thread> threads;
+        std::mutex stateLock;
+        std::condition_variable wake, done;
+        long long queued, pending;
+        size_t next;
+        bool stopping;
+
+        bool Take(size_t index, std::function<void()>& task);
+        void Run(size_t index);
+    };
+
+    // Evaluates a recorded Circuit on TFHE ciphertexts one dependency level at a time. The
+    // bootstrapped gates of a level are independent, so they are spread over the pool; the
+    // cloud key is only read. Requires a TFHE build with the spqlios FFT processor, since
+    // the FFTW one keeps shared scratch buffers.
+    class ParallelExecutor {
+    public:
+        FheContext* context;
+        WorkStealingPool pool;
+        ParallelExecutor(FheContext& newContext, int threadCount = std::thread::hardware_concurrency()) : context(&newContext), pool(threadCount) {}
+        std::vector<RealGateBootstrappedBit> Execute(const Circuit& circuit, const std::vector<RealGateBootstrappedBit>& inputs);
+    };
+
+    template <int N> void AppendBits(std::vector<RealGateBootstrappedBit>& bits, const GenericInt<N, RealGateBootstrappedBit>& a);
+    template <int N> GenericInt<N, RealGateBootstrappedBit> ExtractInt(const std::vector<RealGateBootstrappedBit>& bits, int offset);
+
+    // parallelExecutor.cpp includes the definitions of the pool and the executor
+    #include "parallelExecutor.cpp"
+};
+
+#endif
@@ -0,0 +1,251 @@
+const char sharedCloudKeyMagic[8] = {'F', 'H', 'E', 'S', 'H', 'K', '1', 0};
+const long sharedCloudKeyAlignment = 4096;
+
+// Body and variance of one key switching sample; the mask lives in the coefficient array
+struct SharedKeySwitchTail {
+    double variance;
+    int32_t b;
+    int32_t unused;
+};
+
+void PadTo(FILE *file, long alignment) {
+    long position = ftell(file);
+
+    while (position % alignment != 0)
+    {
+        fputc(0, file);
+        position++;
+    }
+}
+
+SharedCloudKey::SharedCloudKey() {
+    params = NULL;
+    cloudKey = NULL;
+    mapping = NULL;
+    mappingSize = 0;
+    polynomials = NULL;
+    tlweSamples = NULL;
+    gswSamples = NULL;
+    keySwitchSamples = NULL;
+    keySwitchKey = NULL;
+    bootstrappingKey = NULL;
+}
+
+SharedCloudKey::~SharedCloudKey() {
+    Unmap();
+}
+
+bool SharedCloudKey::Save(const TFheGateBootstrappingCloudKeySet *key, const std::string &path) {
+    if (key == NULL || key->bkFFT == NULL)
+        return false;
+
+    const LweBootstrappingKeyFFT *bk = key->bkFFT;
+    const LweKeySwitchKey *ks = bk->ks;
+    SharedCloudKeyHeader header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, sharedCloudKeyMagic, sizeof(header.magic));
+    header.n = bk->in_out_params->n;
+    header.N = bk->accum_params->N;
+    header.k = bk->accum_params->k;
+    header.l = bk->bk_params->l;
+    header.keySwitchN = ks->n;
+    header.keySwitchT = ks->t;
+    header.keySwitchBasebit = ks->basebit;
+    header.keySwitchOutN = ks->out_params->n;
+
+    FILE *file = fopen(path.c_str(), "wb");
+
+    if (file == NULL)
+        return false;
+
+    fwrite(&header, sizeof(header), 1, file);
+
+    header.paramsOffset = ftell(file);
+    export_tfheGateBootstrappingParameterSet_toFile(file, key->params);
+    header.paramsSize = ftell(file) - header.paramsOffset;
+
+    PadTo(file, sharedCloudKeyAlignment);
+    header.bootstrappingOffset = ftell(file);
+
+    for (int i = 0; i < header.n; i++)
+        for (int j = 0; j < (header.k + 1) * header.l; j++)
+            for (int p = 0; p <= header.k; p++)
+                fwrite(bk->bkFFT[i].all_samples[j].a[p].data, sizeof(double), header.N, file);
+
+    int keySwitchCount = ks->n * ks->t * ks->base;
+
+    PadTo(file, sharedCloudKeyAlignment);
+    header.keySwitchOffset = ftell(file);
+
+    for (int i = 0; i < keySwitchCount; i++)
+        fwrite(ks->ks0_raw[i].a, sizeof(Torus32), header.keySwitchOutN, file);
+
+    PadTo(file, sizeof(SharedKeySwitchTail));
+    header.keySwitchTailOffset = ftell(file);
+
+    for (int i = 0; i < keySwitchCount; i++)
+    {
+        SharedKeySwitchTail tail = {ks->ks0_raw[i].current_variance, ks->ks0_raw[i].b, 0};
+
+        fwrite(&tail, sizeof(tail), 1, file);
+    }
+
+    header.size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+
+    bool written = !ferror(file);
+
+    return fclose(file) == 0 && written;
+}
+
+bool SharedCloudKey::Map(const std::string &path) {
+    Unmap();
+
+    int descriptor = open(path.c_str(), O_RDONLY);
+    struct stat status;
+
+    if (descriptor < 0)
+        return false;
+
+    if (fstat(descriptor, &status) != 0 || (size_t)status.st_size < sizeof(SharedCloudKeyHeader))
+    {
+        close(descriptor);
+        return false;
+    }
+
+    void *address = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+
+    if (address == MAP_FAILED)
+        return false;
+
+    mapping = (char*)address;
+    mappingSize = status.st_size;
+
+    SharedCloudKeyHeader header;
+    memcpy(&header, mapping, sizeof(header));
+
+    uint64_t polynomialBytes = (uint64_t)header.n * (header.k + 1) * header.l * (header.k + 1) * header.N * sizeof(double);
+    uint64_t keySwitchCount = (uint64_t)header.keySwitchN * header.keySwitchT * ((uint64_t)1 << header.keySwitchBasebit);
+
+    if (memcmp(header.magic, sharedCloudKeyMagic, sizeof(header.magic)) != 0 || header.size != mappingSize
+        || header.paramsOffset + header.paramsSize > header.bootstrappingOffset
+        || header.bootstrappingOffset + polynomialBytes > header.keySwitchOffset
+        || header.keySwitchOffset + keySwitchCount * header.keySwitchOutN * sizeof(Torus32) > header.keySwitchTailOffset
+        || header.keySwitchTailOffset + keySwitchCount * sizeof(SharedKeySwitchTail) > header.size)
+    {
+        Unmap();
+        return false;
+    }
+
+    FILE *paramsFile = fmemopen(mapping + header.paramsOffset, header.paramsSize, "rb");
+
+    if (paramsFile != NULL)
+    {
+        params = new_tfheGateBootstrappingParameterSet_fromFile(paramsFile);
+        fclose(paramsFile);
+    }
+
+    const TGswParams *bkParams = params != NULL ? params->tgsw_params : NULL;
+    const TLweParams *accumParams = bkParams != NULL ? bkParams->tlwe_params : NULL;
+
+    // The file has to describe the same shapes as its own parameters
+    if (accumParams == NULL || params->in_out_params->n != header.n || accumParams->N != header.N
+        || accumParams->k != header.k || bkParams->l != header.l || params->ks_t != header.keySwitchT
+        || params->ks_basebit != header.keySwitchBasebit || accumParams->extracted_lweparams.n != header.keySwitchN
+        || params->in_out_params->n != header.keySwitchOutN)
+    {
+        Unmap();
+        return false;
+    }
+
+    // Polynomials point into the mapping; the FFT processor is a global, taken from a probe
+    LagrangeHalfCPolynomial *probe = new_LagrangeHalfCPolynomial(header.N);
+    void *precomp = probe->precomp;
+    delete_LagrangeHalfCPolynomial(probe);
+
+    int samplesPerGsw = (header.k + 1) * header.l;
+    int polynomialCount = header.n * samplesPerGsw * (header.k + 1);
+    double *coefficients = (double*)(mapping + header.bootstrappingOffset);
+
+    polynomials = (LagrangeHalfCPolynomial*)malloc(polynomialCount * sizeof(LagrangeHalfCPolynomial));
+    for (int i = 0; i < polynomialCount; i++)
+    {
+        polynomials[i].data = coefficients + (size_t)i * header.N;
+        polynomials[i].precomp = precomp;
+    }
+
+    tlweSamples = (TLweSampleFFT*)malloc(header.n * samplesPerGsw * sizeof(TLweSampleFFT));
+    for (int i = 0; i < header.n * samplesPerGsw; i++)
+        new(tlweSamples + i) TLweSampleFFT(accumParams, polynomials + i * (header.k + 1), 0);
+
+    gswSamples = (TGswSampleFFT*)malloc(header.n * sizeof(TGswSampleFFT));
+    for (int i = 0; i < header.n; i++)
+        new(gswSamples + i) TGswSampleFFT(bkParams, tlweSamples + i * samplesPerGsw);
+
+    // Key switching samples are only read, so their masks can stay in read-only pages
+    Torus32 *masks = (Torus32*)(mapping + header.keySwitchOffset);
+    const SharedKeySwitchTail *tails = (const SharedKeySwitchTail*)(mapping + header.keySwitchTailOffset);
+
+    keySwitchSamples = (LweSample*)malloc(keySwitchCount * sizeof(LweSample));
+    for (uint64_t i = 0; i < keySwitchCount; i++)
+    {
+        keySwitchSamples[i].a = masks + (size_t)i * header.keySwitchOutN;
+        keySwitchSamples[i].b = tails[i].b;
+        keySwitchSamples[i].current_variance = tails[i].variance;
+    }
+
+    keySwitchKey = (LweKeySwitchKey*)malloc(sizeof(LweKeySwitchKey));
+    new(keySwitchKey) LweKeySwitchKey(header.keySwitchN, header.keySwitchT, header.keySwitchBasebit, params->in_out_params, keySwitchSamples);
+
+    bootstrappingKey = (LweBootstrappingKeyFFT*)malloc(sizeof(LweBootstrappingKeyFFT));
+    new(bootstrappingKey) LweBootstrappingKeyFFT(params->in_out_params, bkParams, accumParams, &accumParams->extracted_lweparams, gswSamples, keySwitchKey);
+
+    cloudKey = (TFheGateBootstrappingCloudKeySet*)malloc(sizeof(TFheGateBootstrappingCloudKeySet));
+    new(cloudKey) TFheGateBootstrappingCloudKeySet(params, NULL, bootstrappingKey);
+
+    return true;
+}
+
+// TFHE's own destructors would free the mapped coefficients, so only the parts allocated
+// here are torn down: the per-GSW sample tables and the key switching index arrays
+void SharedCloudKey::Unmap() {
+    SharedCloudKeyHeader header;
+
+    if (mapping != NULL)
+        memcpy(&header, mapping, sizeof(header));
+
+    free(cloudKey);
+    free(bootstrappingKey);
+
+    if (keySwitchKey != NULL)
+        keySwitchKey->~LweKeySwitchKey();
+    free(keySwitchKey);
+    free(keySwitchSamples);
+
+    if (gswSamples != NULL)
+        for (int i = 0; i < header.n; i++)
+            gswSamples[i].~TGswSampleFFT();
+    free(gswSamples);
+    free(tlweSamples);
+    free(polynomials);
+
+    if (params != NULL)
+        delete_gate_bootstrapping_parameters(params);
+
+    if (mapping != NULL)
+        munmap(mapping, mappingSize);
+
+    params = NULL;
+    cloudKey = NULL;
+    mapping = NULL;
+    mappingSize = 0;
+    polynomials = NULL;
+    tlweSamples = NULL;
+    gswSamples = NULL;
+    keySwitchSamples = NULL;
+    keySwitchKey = NULL;
+    bootstrappingKey = NULL;
+}
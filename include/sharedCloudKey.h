@@ -0,0 +1,59 @@
+#ifndef HOMOMORPHIC_ENCRYPTION_SHARED_CLOUD_KEY_H
+#define HOMOMORPHIC_ENCRYPTION_SHARED_CLOUD_KEY_H
+
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+
+namespace homomorphicEvaluation {
+    // Start of a shared cloud key file. The parameters follow in tfhe_io format; the
+    // FFT-domain bootstrapping key and the key switching masks are stored as flat,
+    // page-aligned coefficient arrays that can be used in place once mapped.
+    struct SharedCloudKeyHeader {
+        char magic[8];
+        int32_t n, N, k, l;
+        int32_t keySwitchN, keySwitchT, keySwitchBasebit, keySwitchOutN;
+        uint64_t paramsOffset, paramsSize;
+        uint64_t bootstrappingOffset, keySwitchOffset, keySwitchTailOffset, size;
+    };
+
+    // Cloud key evaluated straight from a read-only shared mapping. Only the small pointer
+    // skeleton TFHE walks is built per process; every coefficient stays in the page cache,
+    // so all evaluators on a host share one copy and startup does no FFTs. Relies on both
+    // TFHE FFT processors keeping N doubles behind LagrangeHalfCPolynomial::data.
+    class SharedCloudKey {
+    public:
+        TFheGateBootstrappingParameterSet* params;
+        TFheGateBootstrappingCloudKeySet* cloudKey;
+        SharedCloudKey();
+        SharedCloudKey(const SharedCloudKey&) = delete;
+        SharedCloudKey& operator=(const SharedCloudKey&) = delete;
+        ~SharedCloudKey();
+        bool Map(const std::string& path);
+        static bool Save(const TFheGateBootstrappingCloudKeySet* key, const std::string& path);
+    private:
+        char* mapping;
+        size_t mappingSize;
+        LagrangeHalfCPolynomial* polynomials;
+        TLweSampleFFT* tlweSamples;
+        TGswSampleFFT* gswSamples;
+        LweSample* keySwitchSamples;
+        LweKeySwitchKey* keySwitchKey;
+        LweBootstrappingKeyFFT* bootstrappingKey;
+        void Unmap();
+    };
+
+    // sharedCloudKey.cpp includes the definitions of the shared key
+    #include "sharedCloudKey.cpp"
+};
+
+#endif
@@ -0,0 +1,230 @@
+int NextPowerOfTwo(int n) {
+    int power = 1;
+
+    while (power < n)
+        power *= 2;
+
+    return power;
+}
+
+void AddComparator(std::vector<Comparator> &stage, int low, int high, int n) {
+    Comparator comparator = {low, high};
+
+    if (high < n)
+        stage.push_back(comparator);
+}
+
+void AddStage(SortingNetwork &network, const std::vector<Comparator> &stage) {
+    if (!stage.empty())
+        network.push_back(stage);
+}
+
+// Bitonic sort with every comparator pointing the same way: the first stage of each merge
+// compares a block against its own mirror image, the rest are half-cleaners
+SortingNetwork BitonicNetwork(int n) {
+    SortingNetwork network;
+    int size = NextPowerOfTwo(n);
+
+    for (int block = 2; block <= size; block *= 2)
+    {
+        std::vector<Comparator> stage;
+
+        for (int i = 0; i < size; i++)
+            if (i < (i ^ (block - 1)))
+                AddComparator(stage, i, i ^ (block - 1), n);
+
+        AddStage(network, stage);
+
+        for (int stride = block / 4; stride >= 1; stride /= 2)
+        {
+            stage.clear();
+
+            for (int i = 0; i < size; i++)
+                if (i < (i ^ stride))
+                    AddComparator(stage, i, i ^ stride, n);
+
+            AddStage(network, stage);
+        }
+    }
+
+    return network;
+}
+
+// Batcher's odd-even merge sort, one stage per merge distance of each merge
+SortingNetwork OddEvenMergeNetwork(int n) {
+    SortingNetwork network;
+
+    for (int part = 1; part < n; part *= 2)
+    {
+        for (int distance = part; distance >= 1; distance /= 2)
+        {
+            std::vector<Comparator> stage;
+
+            for (int j = distance % part; j + distance < n; j += 2 * distance)
+                for (int i = 0; i < distance && i + j + distance < n; i++)
+                    if ((i + j) / (2 * part) == (i + j + distance) / (2 * part))
+                        AddComparator(stage, i + j, i + j + distance, n);
+
+            AddStage(network, stage);
+        }
+    }
+
+    return network;
+}
+
+SortingNetwork TopKNetwork(int n, int k) {
+    if (k >= n)
+        return OddEvenMergeNetwork(n);
+
+    int size = NextPowerOfTwo(std::max(k, 1));
+    int blocks = (n + size - 1) / size;
+    SortingNetwork network, blockNetwork = OddEvenMergeNetwork(size);
+
+    // All blocks are sorted side by side, stage by stage
+    for (size_t s = 0; s < blockNetwork.size(); s++)
+    {
+        std::vector<Comparator> stage;
+
+        for (int b = 0; b < blocks; b++)
+            for (size_t c = 0; c < blockNetwork[s].size(); c++)
+                AddComparator(stage, b * size + blockNetwork[s][c].low, b * size + blockNetwork[s][c].high, n);
+
+        AddStage(network, stage);
+    }
+
+    // The smaller of a sorted block and the mirror of another is bitonic and holds the
+    // smallest size values of both, and half-cleaners sort it again
+    for (int span = 1; span < blocks; span *= 2)
+    {
+        std::vector<Comparator> stage;
+
+        for (int b = 0; b + span < blocks; b += 2 * span)
+            for (int i = 0; i < size; i++)
+                AddComparator(stage, b * size + i, (b + span) * size + size - 1 - i, n);
+
+        AddStage(network, stage);
+
+        for (int stride = size / 2; stride >= 1; stride /= 2)
+        {
+            stage.clear();
+
+            for (int b = 0; b + span < blocks; b += 2 * span)
+                for (int i = 0; i < size; i++)
+                    if (i < (i ^ stride))
+                        AddComparator(stage, b * size + i, b * size + (i ^ stride), n);
+
+            AddStage(network, stage);
+        }
+    }
+
+    return network;
+}
+
+long long GetComparatorCount(const SortingNetwork &network) {
+    long long count = 0;
+
+    for (size_t i = 0; i < network.size(); i++)
+        count += network[i].size();
+
+    return count;
+}
+
+template <int N, class BoolType>
+void ExchangeAt(std::vector<GenericInt<N, BoolType> > &values, const Comparator &comparator, bool descending) {
+    std::pair<GenericInt<N, BoolType>, GenericInt<N, BoolType> > exchanged = compareExchange(values[comparator.low], values[comparator.high]);
+
+    values[comparator.low] = descending ? exchanged.second : exchanged.first;
+    values[comparator.high] = descending ? exchanged.first : exchanged.second;
+}
+
+template <int N, class BoolType>
+void applyNetwork(std::vector<GenericInt<N, BoolType> > &values, const SortingNetwork &network, bool descending) {
+    for (size_t s = 0; s < network.size(); s++)
+        for (size_t c = 0; c < network[s].size(); c++)
+            ExchangeAt(values, network[s][c], descending);
+}
+
+// Each comparator of a stage is a task of its own; the bit type has to be safe to evaluate
+// from several threads, as RealGateBootstrappedBit is
+template <int N, class BoolType>
+void applyNetwork(std::vector<GenericInt<N, BoolType> > &values, const SortingNetwork &network, WorkStealingPool &pool, bool descending) {
+    for (size_t s = 0; s < network.size(); s++)
+    {
+        for (size_t c = 0; c < network[s].size(); c++)
+        {
+            const Comparator &comparator = network[s][c];
+
+            pool.Submit([&values, &comparator, descending]() { ExchangeAt(values, comparator, descending); });
+        }
+
+        pool.Wait();
+    }
+}
+
+// Records move as a whole: one comparison of the keys decides the swap, and the same
+// swap & (a ^ b) mask is applied to the key and the payload bits
+template <int N, int M, class BoolType>
+void applyNetwork(std::vector<GenericInt<N, BoolType> > &keys, std::vector<GenericInt<M, BoolType> > &payloads, const SortingNetwork &network, bool descending) {
+    for (size_t s = 0; s < network.size(); s++)
+    {
+        for (size_t c = 0; c < network[s].size(); c++)
+        {
+            int low = network[s][c].low, high = network[s][c].high;
+            std::array<FoldedBit<BoolType>, N> x = keys[low].GetFoldedBits(), y = keys[high].GetFoldedBits();
+            std::array<FoldedBit<BoolType>, M> u = payloads[low].GetFoldedBits(), v = payloads[high].GetFoldedBits();
+            FoldedBit<BoolType> swap, equal;
+
+            if (descending)
+                CompareBits(y, x, 0, N, true, false, swap, equal);
+            else
+                CompareBits(x, y, 0, N, true, false, swap, equal);
+
+            for (int i = 0; i < N; i++)
+            {
+                FoldedBit<BoolType> difference = FoldedAnd(swap, FoldedXor(x[i], y[i]));
+
+                x[i] = FoldedXor(x[i], difference);
+                y[i] = FoldedXor(y[i], difference);
+            }
+
+            for (int i = 0; i < M; i++)
+            {
+                FoldedBit<BoolType> difference = FoldedAnd(swap, FoldedXor(u[i], v[i]));
+
+                u[i] = FoldedXor(u[i], difference);
+                v[i] = FoldedXor(v[i], difference);
+            }
+
+            keys[low] = keys[low].FromFoldedBits(x);
+            keys[high] = keys[high].FromFoldedBits(y);
+            payloads[low] = payloads[low].FromFoldedBits(u);
+            payloads[high] = payloads[high].FromFoldedBits(v);
+        }
+    }
+}
+
+template <int N, class BoolType>
+void bitonicSort(std::vector<GenericInt<N, BoolType> > &values, bool descending) {
+    applyNetwork(values, BitonicNetwork(values.size()), descending);
+}
+
+template <int N, class BoolType>
+void oddEvenMergeSort(std::vector<GenericInt<N, BoolType> > &values, bool descending) {
+    applyNetwork(values, OddEvenMergeNetwork(values.size()), descending);
+}
+
+template <int N, int M, class BoolType>
+void sortByKey(std::vector<GenericInt<N, BoolType> > &keys, std::vector<GenericInt<M, BoolType> > &payloads, bool descending) {
+    applyNetwork(keys, payloads, OddEvenMergeNetwork(keys.size()), descending);
+}
+
+// The k largest values, largest first, or the k smallest, smallest first
+template <int N, class BoolType>
+std::vector<GenericInt<N, BoolType> > topK(std::vector<GenericInt<N, BoolType> > values, int k, bool largest) {
+    k = std::max(0, std::min(k, (int)values.size()));
+
+    applyNetwork(values, TopKNetwork(values.size(), k), largest);
+    values.resize(k);
+
+    return values;
+}
@@ -0,0 +1,41 @@
+#ifndef HOMOMORPHIC_ENCRYPTION_SORTING_NETWORKS_H
+#define HOMOMORPHIC_ENCRYPTION_SORTING_NETWORKS_H
+
+#include <vector>
+#include <utility>
+#include "homomorphicEvaluation.h"
+#include "parallelExecutor.h"
+
+namespace homomorphicEvaluation {
+    // One compare-exchange: afterwards the smaller value is at low and the larger at high,
+    // or the other way round when a network is applied in descending order
+    struct Comparator {
+        int low, high;
+    };
+
+    // A data-oblivious network as a list of stages. The comparators of a stage touch
+    // disjoint positions, so every stage is a batch that can run concurrently.
+    typedef std::vector<std::vector<Comparator> > SortingNetwork;
+
+    // Networks for any n, built as the power-of-two network with the comparators that
+    // reach past n dropped, which is what padding with values larger than any key gives
+    SortingNetwork BitonicNetwork(int n);
+    SortingNetwork OddEvenMergeNetwork(int n);
+    // Leaves the k smallest of n values sorted in positions 0 to k - 1: blocks of k are
+    // sorted, then merged pairwise keeping only the smaller half of each pair
+    SortingNetwork TopKNetwork(int n, int k);
+    long long GetComparatorCount(const SortingNetwork& network);
+
+    template <int N, class BoolType> void applyNetwork(std::vector<GenericInt<N, BoolType> >& values, const SortingNetwork& network, bool descending = false);
+    template <int N, class BoolType> void applyNetwork(std::vector<GenericInt<N, BoolType> >& values, const SortingNetwork& network, WorkStealingPool& pool, bool descending = false);
+    template <int N, int M, class BoolType> void applyNetwork(std::vector<GenericInt<N, BoolType> >& keys, std::vector<GenericInt<M, BoolType> >& payloads, const SortingNetwork& network, bool descending = false);
+    template <int N, class BoolType> void bitonicSort(std::vector<GenericInt<N, BoolType> >& values, bool descending = false);
+    template <int N, class BoolType> void oddEvenMergeSort(std::vector<GenericInt<N, BoolType> >& values, bool descending = false);
+    template <int N, int M, class BoolType> void sortByKey(std::vector<GenericInt<N, BoolType> >& keys, std::vector<GenericInt<M, BoolType> >& payloads, bool descending = false);
+    template <int N, class BoolType> std::vector<GenericInt<N, BoolType> > topK(std::vector<GenericInt<N, BoolType> > values, int k, bool largest = true);
+
+    // sortingNetworks.cpp includes the network builders and the encrypted sorts
+    #include "sortingNetworks.cpp"
+};
+
+#endif
@@ -3,14 +3,16 @@
 #include <vector>
 #include <tfhe/tfhe.h>
 #include <tfhe/tfhe_io.h>
-#include "../include/homomorphicEvaluation.h"
+#include "../include/encryptedSearch.h"
+#include "../include/accumulator.h"
+#include "../include/lazyBit.h"
 
 using namespace std;
 using namespace homomorphicEvaluation;
 
 bool Searching() {
     Computation cycle;
-    GenericInt32<SimulatedGateBootstrappedBit> a[10];
+    vector<GenericInt32<SimulatedGateBootstrappedBit> > a(10);
 
     for(int i = 0; i < 10; i++) {
         a[i].Initialize(rand() % 25, cycle);
@@ -20,19 +22,13 @@ bool Searching() {
     x.Initialize(cycle);
     x = a[4];
 
-    SimulatedGateBootstrappedBit result(0);
-    result.Initialize(cycle);
-
-    for(int i = 0; i < 10; i++) {
-        result = result | (x == a[i]);
-    }
-
-    return result.value;
+    return contains(x, a).value;
 }
 
 int Counting() {
     Computation cycle;
-    GenericInt32<SimulatedGateBootstrappedBit> a[10], x, result, zero(0), one(1);
+    vector<GenericInt32<SimulatedGateBootstrappedBit> > a(10);
+    GenericInt32<SimulatedGateBootstrappedBit> x, result;
 
     for(int i = 0; i < 10; i++) {
         a[i].Initialize(rand() % 25, cycle);
@@ -41,11 +37,7 @@ int Counting() {
     x.Initialize(cycle);
     x = a[4];
 
-    result.Initialize(cycle);
-
-    for(int i = 0; i < 10; i++) {
-        result = result + (x == a[i]);
-    }
+    result = popcount<32>(equalAll(x, a));
 
     int ans = 0;
     for(int i = 31; i >= 0; i--) {
@@ -56,8 +48,100 @@ int Counting() {
     return ans;
 }
 
+void SearchingRecorded() {
+    Circuit circuit;
+    vector<GenericInt32<RecordedBit> > a(10);
+    GenericInt32<RecordedBit> x;
+
+    for(int i = 0; i < 10; i++) {
+        a[i].Initialize(rand() % 25, circuit);
+    }
+
+    x.Initialize(circuit);
+
+    circuit.AddOutput(contains(x, a));
+
+    cout<<circuit.GetGateCount()<<" "<<circuit.GetDepth()<<endl;
+}
+
+// Membership in 10000 encrypted records and in 10000 public values, and a lookup by an
+// encrypted index into 1024 encrypted records
+void MembershipRecorded() {
+    Circuit encrypted, shared, indexed;
+    vector<GenericInt32<RecordedBit> > a(10000), b(1024);
+    vector<unsigned long long> values(10000);
+    GenericInt32<RecordedBit> x, y;
+    GenericInt<10, RecordedBit> index;
+
+    for(int i = 0; i < 10000; i++) {
+        values[i] = rand();
+        a[i].Initialize(values[i], encrypted);
+    }
+
+    for(int i = 0; i < 1024; i++) {
+        b[i].Initialize(rand(), indexed);
+    }
+
+    x.Initialize(encrypted);
+    y.Initialize(shared);
+    index.Initialize(indexed);
+
+    encrypted.AddOutput(contains(x, a));
+    shared.AddOutput(contains(y, values));
+    indexed.AddOutput(lookup(b, index));
+
+    cout<<encrypted.GetGateCount()<<" "<<encrypted.GetDepth()<<endl;
+    cout<<shared.GetGateCount()<<" "<<shared.GetDepth()<<endl;
+    cout<<indexed.GetGateCount()<<" "<<indexed.GetDepth()<<endl;
+}
+
+void CountingRecorded(AdderType adder) {
+    Circuit circuit;
+    vector<GenericInt32<RecordedBit> > a(10);
+    GenericInt32<RecordedBit> x;
+
+    for(int i = 0; i < 10; i++) {
+        a[i].Initialize(rand() % 25, circuit);
+    }
+
+    x.Initialize(circuit);
+
+    circuit.AddOutput(popcount<32>(equalAll(x, a), adder));
+
+    cout<<circuit.GetGateCount()<<" "<<circuit.GetDepth()<<endl;
+}
+
+// The serial loop written against LazyBit: it builds the whole search before anything is
+// evaluated, and the scheduler runs it in a few dozen waves of independent gates
+void SearchingLazy() {
+    WorkStealingPool pool;
+    LazyScheduler<bool> scheduler(pool);
+    vector<GenericInt32<LazyBit<bool> > > a(10);
+    GenericInt32<LazyBit<bool> > x;
+    LazyBit<bool> result(0);
+
+    for(int i = 0; i < 10; i++) {
+        a[i] = MakeLazy(GenericInt32<bool>(rand() % 25), scheduler);
+    }
+
+    x = a[4];
+
+    for(int i = 0; i < 10; i++) {
+        result = result | (x == a[i]);
+    }
+
+    cout<<result.Get()<<" "<<scheduler.GetNodeCount()<<" "<<scheduler.GetWaveCount()<<endl;
+}
+
 int main(){
     cout<<Searching()<<endl;
     cout<<Counting()<<endl;
+    SearchingRecorded();
+    MembershipRecorded();
+    CountingRecorded(AdderType::RippleCarry);
+    CountingRecorded(AdderType::KoggeStone);
+    CountingRecorded(AdderType::BrentKung);
+    CountingRecorded(AdderType::Sklansky);
+    SearchingLazy();
     return 0;
 }
\ No newline at end of file
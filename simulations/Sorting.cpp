@@ -1,57 +1,108 @@
 #include <iostream>
+#include <sstream>
 #include <cmath>
 #include <vector>
 #include <tfhe/tfhe.h>
 #include <tfhe/tfhe_io.h>
-#include "../include/homomorphicEvaluation.h"
+#include "../include/bootstrapPlanner.h"
+#include "../include/sortingNetworks.h"
 
 using namespace std;
 using namespace homomorphicEvaluation;
 
-void BubbleSortGate() {
+vector<CostModel> Models() {
+    vector<CostModel> models;
+    models.push_back(CostModel::TfheGate());
+    models.push_back(CostModel::Fhew());
+    models.push_back(CostModel::FreeXor());
+
+    return models;
+}
+
+void NetworkSortGate() {
     Computation cycle;
-    GenericInt32<SimulatedGateBootstrappedBit> a[10];
+    vector<GenericInt32<SimulatedGateBootstrappedBit> > a(10);
 
     for(int i = 0; i < 10; i++) {
         a[i].Initialize(rand() % 25, cycle);
     }
 
+    oddEvenMergeSort(a);
+
+    cycle.WriteJson(cout, Models());
+}
+
+void NetworkSortCircuit() {
+    Computation cycle;
+    vector<GenericInt32<SimulatedCircuitBootstrappedBit> > a(10);
+
     for(int i = 0; i < 10; i++) {
-        for(int j = i + 1; j < 10; j++) {
-            GenericInt32<SimulatedGateBootstrappedBit> minValue, maxValue;
+        a[i].Initialize(rand() % 25, cycle);
+    }
 
-            minValue = min(a[i], a[j]);
-            maxValue = max(a[i], a[j]);
+    oddEvenMergeSort(a);
 
-            a[i] = minValue;
-            a[j] = maxValue;
-        }
+    cycle.WriteJson(cout, Models());
+}
+
+void NetworkSortRecorded() {
+    Circuit circuit;
+    vector<GenericInt32<RecordedBit> > a(10);
+
+    for(int i = 0; i < 10; i++) {
+        a[i].Initialize(rand() % 25, circuit);
     }
 
-    cout<<cycle.GetBootstrapping()<<endl;
+    oddEvenMergeSort(a);
+
+    for(int i = 0; i < 10; i++) {
+        circuit.AddOutput(a[i]);
+    }
+
+    cout<<"{\"gates\": "<<circuit.GetGateCount()<<", \"depth\": "<<circuit.GetDepth()<<"}"<<endl;
 }
 
-void BubbleSortCircuit() {
+// Critical path, width and makespan of the sort on 1, 4 and 16 cores
+void NetworkSortProfiled() {
     Computation cycle;
-    GenericInt32<SimulatedCircuitBootstrappedBit> a[10];
+    vector<GenericInt32<ProfiledBit> > a(10);
 
     for(int i = 0; i < 10; i++) {
         a[i].Initialize(rand() % 25, cycle);
     }
 
+    oddEvenMergeSort(a);
+
+    vector<int> cores;
+    cores.push_back(1);
+    cores.push_back(4);
+    cores.push_back(16);
+
+    cycle.WriteProfile(cout, CostModel::TfheGate(), cores);
+}
+
+// Bootstraps of the recorded sort under levelled depth budgets, placed greedily as
+// SimulatedLevelledBit does and by the planner
+void NetworkSortLevelled() {
+    Circuit circuit;
+    vector<GenericInt32<RecordedBit> > a(10);
+
     for(int i = 0; i < 10; i++) {
-        for(int j = i + 1; j < 10; j++) {
-            GenericInt32<SimulatedCircuitBootstrappedBit> minValue, maxValue;
+        a[i].Initialize(rand() % 25, circuit);
+    }
 
-            minValue = min(a[i], a[j]);
-            maxValue = max(a[i], a[j]);
+    oddEvenMergeSort(a);
 
-            a[i] = minValue;
-            a[j] = maxValue;
-        }
+    for(int i = 0; i < 10; i++) {
+        circuit.AddOutput(a[i]);
     }
 
-    cout<<cycle.GetBootstrapping()<<endl;
+    for(long long depth = 2; depth <= 16; depth *= 2) {
+        BootstrapPlanner planner(depth);
+
+        cout<<"{\"depth\": "<<depth<<", \"greedy\": "<<planner.Greedy(circuit).GetBootstrapping()
+            <<", \"planned\": "<<planner.Plan(circuit).GetBootstrapping()<<"}"<<endl;
+    }
 }
 
 /*void SelectionSortGate() {
@@ -73,9 +124,43 @@ void BubbleSortCircuit() {
     cout<<cycle.GetBootstrapping()<<endl;
 }*/
 
+// Bootstraps and depth in comparators of bitonic and odd-even merge sorts and of the top 8
+// selection as the number of values grows, one JSON line per network holding its report
+void NetworkScaling() {
+    const char *names[3] = {"bitonic", "oddEvenMerge", "top8"};
+
+    for(int n = 16; n <= 1024; n *= 4) {
+        SortingNetwork networks[3] = {BitonicNetwork(n), OddEvenMergeNetwork(n), TopKNetwork(n, 8)};
+
+        for(int k = 0; k < 3; k++) {
+            Computation cycle;
+            vector<GenericInt32<SimulatedGateBootstrappedBit> > a(n);
+
+            for(int i = 0; i < n; i++) {
+                a[i].Initialize(rand() % 100000, cycle);
+            }
+
+            applyNetwork(a, networks[k]);
+
+            stringstream report;
+            cycle.WriteJson(report, Models());
+
+            string json = report.str();
+            json.erase(json.find_last_not_of('\n') + 1);
+
+            cout<<"{\"values\": "<<n<<", \"network\": \""<<names[k]<<"\", \"stages\": "<<networks[k].size()
+                <<", \"report\": "<<json<<"}"<<endl;
+        }
+    }
+}
+
 int main(){
-    BubbleSortGate();
-    BubbleSortCircuit();
+    NetworkSortGate();
+    NetworkSortCircuit();
+    NetworkSortRecorded();
+    NetworkSortLevelled();
+    NetworkSortProfiled();
+    NetworkScaling();
     //cout<<SelectionSort()<<endl;
     return 0;
 }
\ No newline at end of file
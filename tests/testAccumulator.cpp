@@ -0,0 +1,157 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/accumulator.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+template <int N, class BoolType>
+long long Value(const GenericInt<N, BoolType> &a) {
+    long long value = 0;
+
+    for(int i = N - 1; i >= 0; i--) {
+        value = value * 2 + (bool)a.encValue[i].value;
+    }
+
+    return value;
+}
+
+template <int N>
+long long Value(const GenericInt<N, bool> &a) {
+    long long value = 0;
+
+    for(int i = N - 1; i >= 0; i--) {
+        value = value * 2 + a.encValue[i];
+    }
+
+    return value;
+}
+
+bool TestPopcount() {
+    bool flag = true;
+
+    for(int n = 0; n < 200; n += 7) {
+        vector<bool> bits(n);
+        int count = 0;
+
+        for(int i = 0; i < n; i++) {
+            bits[i] = rand() % 3 == 0;
+            count += bits[i];
+        }
+
+        flag &= Value(popcount<32>(bits)) == count && Value(popcount<4>(bits)) == count % 16;
+    }
+
+    return flag;
+}
+
+// Counting a thousand bits costs about as many full adders as bits, instead of a 32-bit
+// increment per bit, and is logarithmically deep
+bool TestPopcountCost() {
+    Computation tree, increments;
+    vector<SimulatedGateBootstrappedBit> bits(1000), others(1000);
+    GenericInt32<SimulatedGateBootstrappedBit> total(0);
+    int count = 0;
+
+    for(int i = 0; i < 1000; i++) {
+        bool bit = rand() % 2;
+        bits[i].Initialize(bit, tree);
+        others[i].Initialize(bit, increments);
+        count += bit;
+    }
+
+    total.Initialize(0, increments);
+
+    for(int i = 0; i < 1000; i++) {
+        total = total + others[i];
+    }
+
+    GenericInt32<SimulatedGateBootstrappedBit> result = popcount<32>(bits);
+
+    Circuit circuit;
+    vector<RecordedBit> recorded(1000);
+
+    for(int i = 0; i < 1000; i++) {
+        recorded[i].Initialize(0, circuit);
+    }
+
+    circuit.AddOutput(popcount<32>(recorded));
+
+    cout<<tree.GetBootstrapping()<<" "<<increments.GetBootstrapping()<<" "<<circuit.GetDepth()<<endl;
+
+    return Value(result) == count && Value(total) == count && tree.GetBootstrapping() * 10 < increments.GetBootstrapping()
+        && circuit.GetDepth() < 60;
+}
+
+bool TestSum() {
+    bool flag = true;
+
+    for(int n = 0; n < 40; n += 3) {
+        vector<GenericInt32<bool> > values;
+        unsigned int expected = 0;
+
+        for(int i = 0; i < n; i++) {
+            unsigned int value = rand() * 4096u + rand();
+            values.push_back(GenericInt32<bool>(value));
+            expected += value;
+        }
+
+        flag &= Value(sum(values)) == expected;
+    }
+
+    Circuit tree, chain;
+    vector<GenericInt32<RecordedBit> > a(64), b(64);
+    GenericInt32<RecordedBit> total;
+
+    for(int i = 0; i < 64; i++) {
+        a[i].Initialize(tree);
+        b[i].Initialize(chain);
+    }
+
+    total = b[0];
+
+    for(int i = 1; i < 64; i++) {
+        total = total + b[i];
+    }
+
+    tree.AddOutput(sum(a));
+    chain.AddOutput(total);
+
+    cout<<tree.GetBootstrapping()<<" "<<tree.GetDepth()<<" "<<chain.GetBootstrapping()<<" "<<chain.GetDepth()<<endl;
+
+    // A full adder per operand bit costs what a ripple-carry adder does; the gain is depth
+    return flag && tree.GetBootstrapping() * 10 <= chain.GetBootstrapping() * 11 && tree.GetDepth() * 2 < chain.GetDepth();
+}
+
+// A stream compressed in small batches gives the same totals as the whole tree
+bool TestAccumulator() {
+    Accumulator<32, bool> count(5), total(5);
+    unsigned int bits = 0, values = 0;
+
+    for(int i = 0; i < 500; i++) {
+        bool bit = rand() % 2;
+        unsigned int value = rand() * 4096u + rand();
+
+        count.Add(bit);
+        total.Add(GenericInt32<bool>(value));
+        bits += bit;
+        values += value;
+    }
+
+    return Value(count.GetSum()) == bits && Value(total.GetSum()) == values;
+}
+
+int main() {
+    bool flag = true;
+
+    flag &= Report(TestPopcount());
+    flag &= Report(TestPopcountCost());
+    flag &= Report(TestSum());
+    flag &= Report(TestAccumulator());
+    return flag ? 0 : 1;
+}
@@ -4,6 +4,7 @@
 #include <tfhe/tfhe.h>
 #include <tfhe/tfhe_io.h>
 #include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
 
 using namespace std;
 using namespace homomorphicEvaluation;
@@ -43,8 +44,6 @@ bool TestAddition() {
         real /= 2;
     }
 
-    cout<<cycle.GetBootstrapping()<<endl;
-
     return flag;
 }
 
@@ -66,15 +65,53 @@ bool TestAdditionCircuit() {
         real /= 2;
     }
 
-    cout<<cycle.GetBootstrapping()<<endl;
+    return flag;
+}
+
+bool TestAdderTypes() {
+    AdderType types[4] = {AdderType::RippleCarry, AdderType::KoggeStone, AdderType::BrentKung, AdderType::Sklansky};
+    bool flag = true;
+
+    for(int t = 0; t < 4; t++) {
+        Circuit circuit;
+        GenericInt32<RecordedBit> x, y;
+        x.adder = types[t];
+        x.Initialize(circuit);
+        y.Initialize(circuit);
+        circuit.AddOutput(x + y);
+
+        cout<<circuit.GetGateCount()<<" "<<circuit.GetDepth()<<endl;
+
+        for(int k = 0; k < 100; k++) {
+            int p = rand() % 100000, q = rand() % 100000;
+            GenericInt32<bool> a(p), b(q), c, d, e, f;
+            a.adder = types[t];
+
+            c = a + b;
+            d = a - b;
+            e = a++;
+            f = a + b.encValue[k % 32];
+
+            unsigned int sum = p + q, difference = (unsigned int)p - (unsigned int)q, next = p + 1, increment = p + b.encValue[k % 32];
+            for(int i = 0; i < 32; i++) {
+                flag &= (c.encValue[i] == ((sum >> i) & 1));
+                flag &= (d.encValue[i] == ((difference >> i) & 1));
+                flag &= (e.encValue[i] == ((next >> i) & 1));
+                flag &= (f.encValue[i] == ((increment >> i) & 1));
+            }
+        }
+    }
 
     return flag;
 }
 
 int main(){
-    cout<<TestAdditionBool()<<endl;
-    cout<<TestAddition()<<endl;
-    cout<<TestAdditionCircuit()<<endl;
+    bool flag = true;
+
+    flag &= Report(TestAdditionBool());
+    flag &= Report(TestAddition());
+    flag &= Report(TestAdditionCircuit());
+    flag &= Report(TestAdderTypes());
 
-    return 0;
+    return flag ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/bitSlicedBit.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+unsigned long long RandomWord() {
+    return ((unsigned long long)rand() << 32) ^ ((unsigned long long)rand() << 16) ^ rand();
+}
+
+bool TestPacking() {
+    vector<unsigned long long> values;
+
+    for(int i = 0; i < bitSliceLanes - 3; i++) {
+        values.push_back(RandomWord() & 0xFFFFFFFFULL);
+    }
+
+    vector<unsigned long long> unpacked = UnpackLanes(PackLanes<32>(values));
+    bool flag = unpacked.size() == (size_t)bitSliceLanes;
+
+    for(int i = 0; i < bitSliceLanes && flag; i++) {
+        flag &= unpacked[i] == (i < (int)values.size() ? values[i] : 0);
+    }
+
+    return flag;
+}
+
+// Every gate of the library on every lane matches its truth table
+bool TestGates() {
+    BitSlicedBit a, b;
+    bool flag = true;
+
+    for(int i = 0; i < bitSliceLanes; i++) {
+        a.SetLane(i, i & 1);
+        b.SetLane(i, (i >> 1) & 1);
+    }
+
+    for(int k = (int)Operation::And; k <= (int)Operation::OrYN; k++) {
+        BitSlicedBit c = ApplyGate((Operation)k, a, b);
+
+        for(int i = 0; i < bitSliceLanes; i++) {
+            flag &= c.GetLane(i) == GateOutput((Operation)k, i & 1, (i >> 1) & 1);
+        }
+    }
+
+    BitSlicedBit s = mux(a, b, !b);
+
+    for(int i = 0; i < bitSliceLanes; i++) {
+        flag &= s.GetLane(i) == ((i & 1) ? ((i >> 1) & 1) : !((i >> 1) & 1));
+    }
+
+    return flag;
+}
+
+// Sweeps of the arithmetic circuits against the processor, one run per bitSliceLanes vectors
+bool TestArithmeticSweep() {
+    bool flag = true;
+    clock_t start = clock();
+    long long vectors = 0;
+
+    for(int run = 0; run < 256; run++) {
+        vector<unsigned long long> x(bitSliceLanes), y(bitSliceLanes);
+
+        for(int i = 0; i < bitSliceLanes; i++) {
+            x[i] = RandomWord() & 0xFFFFFFFFULL;
+            y[i] = (RandomWord() >> (rand() % 32)) & 0xFFFFFFFFULL;
+        }
+
+        GenericInt32<BitSlicedBit> a = PackLanes<32>(x), b = PackLanes<32>(y);
+        vector<unsigned long long> sum = UnpackLanes(a + b), difference = UnpackLanes(a - b);
+        vector<unsigned long long> product = UnpackLanes(a * b), quotient = UnpackLanes(a / b), remainder = UnpackLanes(a % b);
+
+        for(int i = 0; i < bitSliceLanes; i++) {
+            unsigned int p = x[i], q = y[i];
+
+            flag &= sum[i] == (unsigned int)(p + q) && difference[i] == (unsigned int)(p - q) && product[i] == (unsigned int)(p * q);
+
+            if(q != 0) {
+                flag &= quotient[i] == p / q && remainder[i] == p % q;
+            }
+        }
+
+        vectors += bitSliceLanes;
+    }
+
+    cout<<vectors<<" "<<(double)(clock() - start) / CLOCKS_PER_SEC<<endl;
+
+    return flag;
+}
+
+// A recorded circuit runs on the sliced bits through Circuit::Execute as well
+bool TestCircuitSweep() {
+    Circuit circuit;
+    GenericInt<16, RecordedBit> a, b;
+    a.Initialize(circuit);
+    b.Initialize(circuit);
+    circuit.AddOutput(a * b);
+
+    vector<BitSlicedBit> inputs(32);
+    vector<unsigned long long> x(bitSliceLanes), y(bitSliceLanes);
+
+    for(int i = 0; i < bitSliceLanes; i++) {
+        x[i] = rand() % 65536;
+        y[i] = rand() % 65536;
+    }
+
+    GenericInt<16, BitSlicedBit> p = PackLanes<16>(x), q = PackLanes<16>(y), product;
+
+    for(int i = 0; i < 16; i++) {
+        inputs[i] = p.encValue[i];
+        inputs[16 + i] = q.encValue[i];
+    }
+
+    vector<BitSlicedBit> outputs = circuit.Execute(inputs);
+
+    for(int i = 0; i < 16; i++) {
+        product.encValue[i] = outputs[i];
+    }
+
+    vector<unsigned long long> result = UnpackLanes(product);
+    bool flag = true;
+
+    for(int i = 0; i < bitSliceLanes; i++) {
+        flag &= result[i] == ((x[i] * y[i]) & 0xFFFF);
+    }
+
+    return flag;
+}
+
+int main() {
+    bool flag = true;
+
+    flag &= Report(TestPacking());
+    flag &= Report(TestGates());
+    flag &= Report(TestArithmeticSweep());
+    flag &= Report(TestCircuitSweep());
+    return flag ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/bootstrapPlanner.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+Circuit RecordMultiplication() {
+    Circuit circuit;
+    GenericInt32<RecordedBit> a(0), b(0);
+    a.Initialize(circuit);
+    b.Initialize(circuit);
+    circuit.AddOutput(a * b);
+
+    return circuit;
+}
+
+Circuit RecordSort() {
+    Circuit circuit;
+    GenericInt<8, RecordedBit> a[6];
+
+    for(int i = 0; i < 6; i++) {
+        a[i].Initialize(0, circuit);
+    }
+
+    for(int i = 0; i < 6; i++) {
+        for(int j = i + 1; j < 6; j++) {
+            pair<GenericInt<8, RecordedBit>, GenericInt<8, RecordedBit> > exchanged = compareExchange(a[i], a[j]);
+
+            a[i] = exchanged.first;
+            a[j] = exchanged.second;
+        }
+    }
+
+    for(int i = 0; i < 6; i++) {
+        circuit.AddOutput(a[i]);
+    }
+
+    return circuit;
+}
+
+// The greedy plan costs exactly what SimulatedLevelledBit pays replaying the circuit
+bool TestGreedyMatchesLevelledBit() {
+    Circuit circuit = RecordMultiplication();
+    bool flag = true;
+
+    for(long long depth = 1; depth <= 8; depth *= 2) {
+        Computation computation;
+        vector<SimulatedLevelledBit> inputs(64);
+
+        for(int i = 0; i < 64; i++) {
+            inputs[i].Initialize(rand() % 2, depth, computation);
+        }
+
+        circuit.Execute(inputs);
+
+        BootstrapPlan plan = BootstrapPlanner(depth).Greedy(circuit);
+        flag &= plan.IsValid(circuit) && plan.GetBootstrapping() == computation.GetBootstrapping();
+    }
+
+    return flag;
+}
+
+// One wire at the top of the budget read by four gates: greedy refreshes all four readers,
+// the plan refreshes the wire once
+bool TestSharedRefresh() {
+    Circuit circuit;
+    int x = circuit.AddInput(), y = circuit.AddInput();
+    int w = circuit.AddGate(GateType::Xor, circuit.AddGate(GateType::And, x, y), y);
+
+    for(int i = 0; i < 4; i++) {
+        circuit.outputs.push_back(circuit.AddGate(i % 2 ? GateType::Or : GateType::And, w, i < 2 ? x : y));
+    }
+
+    BootstrapPlanner planner(2);
+    BootstrapPlan greedy = planner.Greedy(circuit), plan = planner.Plan(circuit);
+
+    plan.Write(cout);
+
+    return greedy.GetBootstrapping() == 4 && plan.GetBootstrapping() == 1 && plan.refresh[w] && plan.IsValid(circuit);
+}
+
+// Planned refreshes run on the planned backend, compute the product and never cost more
+// than greedy placement
+bool TestPlannedExecution() {
+    Circuit circuit = RecordMultiplication();
+    bool flag = true;
+
+    for(long long depth = 2; depth <= 16; depth *= 2) {
+        BootstrapPlanner planner(depth);
+        BootstrapPlan greedy = planner.Greedy(circuit), plan = planner.Plan(circuit);
+        Computation computation;
+        vector<PlannedLevelledBit> inputs(64), outputs;
+
+        for(int i = 0; i < 64; i++) {
+            inputs[i].Initialize(i < 32 ? (1234 >> i) & 1 : (567 >> (i - 32)) & 1, depth, computation);
+        }
+
+        cout<<depth<<" "<<greedy.GetBootstrapping()<<" "<<plan.GetBootstrapping()<<endl;
+
+        flag &= plan.Execute(circuit, inputs, outputs) && computation.GetBootstrapping() == plan.GetBootstrapping()
+            && plan.GetBootstrapping() <= greedy.GetBootstrapping() && outputs.size() == 32;
+
+        for(int i = 0; i < 32 && flag; i++) {
+            flag &= outputs[i].value == (((1234 * 567) >> i) & 1) && outputs[i].level <= depth;
+        }
+    }
+
+    return flag;
+}
+
+// A plan with a refresh taken away is rejected both by the check and by the backend
+bool TestInvalidPlan() {
+    Circuit circuit = RecordSort();
+    BootstrapPlan plan = BootstrapPlanner(3).Plan(circuit);
+    bool flag = plan.IsValid(circuit);
+
+    cout<<BootstrapPlanner(3).Greedy(circuit).GetBootstrapping()<<" "<<plan.GetBootstrapping()<<endl;
+
+    for(size_t i = 0; i < plan.refresh.size(); i++) {
+        if(plan.refresh[i]) {
+            plan.refresh[i] = false;
+            break;
+        }
+    }
+
+    Computation computation;
+    vector<PlannedLevelledBit> inputs(circuit.inputs.size()), outputs;
+
+    for(size_t i = 0; i < inputs.size(); i++) {
+        inputs[i].Initialize(rand() % 2, 3, computation);
+    }
+
+    return flag && !plan.IsValid(circuit) && !plan.Execute(circuit, inputs, outputs);
+}
+
+int main() {
+    bool flag = true;
+
+    flag &= Report(TestGreedyMatchesLevelledBit());
+    flag &= Report(TestSharedRefresh());
+    flag &= Report(TestPlannedExecution());
+    flag &= Report(TestInvalidPlan());
+    return flag ? 0 : 1;
+}
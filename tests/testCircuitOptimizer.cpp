@@ -0,0 +1,179 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/circuitOptimizer.h"
+#include "../include/parallelExecutor.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+FheContext context;
+
+vector<bool> RandomBits(int n) {
+    vector<bool> bits;
+
+    for(int i = 0; i < n; i++) {
+        bits.push_back(rand() % 2);
+    }
+
+    return bits;
+}
+
+bool SameFunction(const Circuit &a, const Circuit &b) {
+    bool flag = a.inputs.size() == b.inputs.size() && a.outputs.size() == b.outputs.size();
+
+    for(int i = 0; i < 64 && flag; i++) {
+        vector<bool> bits = RandomBits(a.inputs.size());
+        flag &= a.Evaluate(bits) == b.Evaluate(bits);
+    }
+
+    return flag;
+}
+
+bool TestConstantPropagation() {
+    Circuit circuit;
+    int x = circuit.AddInput(), y = circuit.AddInput();
+    int zero = circuit.AddConstant(0), one = circuit.AddConstant(1);
+
+    circuit.outputs.push_back(circuit.AddGate(GateType::And, x, zero));
+    circuit.outputs.push_back(circuit.AddGate(GateType::Xor, y, one));
+    circuit.outputs.push_back(circuit.AddGate(GateType::Mux, x, zero, y));
+    circuit.outputs.push_back(circuit.AddGate(GateType::Or, x, x));
+
+    CircuitOptimizer optimizer;
+    Circuit result = optimizer.EliminateDeadGates(optimizer.PropagateConstants(circuit));
+
+    // x & 0 and x | x vanish, y ^ 1 becomes a free NOT and the MUX becomes !x & y
+    return SameFunction(circuit, result) && result.GetBootstrapping() == 1 && optimizer.reports.size() == 2
+        && optimizer.reports[0].bootstrapsBefore == 5 && optimizer.reports[0].bootstrapsAfter == 1;
+}
+
+bool TestCommonSubexpressions() {
+    Circuit circuit;
+    int x = circuit.AddInput(), y = circuit.AddInput();
+    int a = circuit.AddGate(GateType::And, x, y), b = circuit.AddGate(GateType::And, y, x);
+
+    circuit.outputs.push_back(circuit.AddGate(GateType::Xor, a, x));
+    circuit.outputs.push_back(circuit.AddGate(GateType::Xor, b, x));
+
+    CircuitOptimizer optimizer;
+    Circuit result = optimizer.EliminateCommonSubexpressions(circuit);
+
+    return SameFunction(circuit, result) && result.GetGateCount() == 2 && result.outputs[0] == result.outputs[1];
+}
+
+bool TestNotAbsorption() {
+    Circuit circuit;
+    int x = circuit.AddInput(), y = circuit.AddInput(), s = circuit.AddInput();
+    int notX = circuit.AddGate(GateType::Not, x), notY = circuit.AddGate(GateType::Not, y);
+    int both = circuit.AddGate(GateType::And, notX, notY);
+
+    circuit.outputs.push_back(circuit.AddGate(GateType::Not, both));
+    circuit.outputs.push_back(circuit.AddGate(GateType::Mux, circuit.AddGate(GateType::Not, s), x, y));
+
+    CircuitOptimizer optimizer;
+    Circuit result = optimizer.EliminateDeadGates(optimizer.AbsorbNots(circuit));
+
+    // !(!x & !y) is x | y, and the negated selector swaps the MUX inputs
+    return SameFunction(circuit, result) && result.GetGateCount() == 2 && result.GetGateCount(GateType::Not) == 0;
+}
+
+bool TestOptimizedMultiplication() {
+    Circuit circuit;
+    GenericInt32<RecordedBit> a(0), b(0), c(0);
+    a.Initialize(circuit);
+    b.Initialize(circuit);
+
+    c = a * b;
+    circuit.AddOutput(c);
+
+    CircuitOptimizer optimizer;
+    Circuit result = optimizer.Optimize(circuit);
+
+    cout<<circuit.GetBootstrapping()<<" "<<circuit.GetDepth()<<" "<<result.GetBootstrapping()<<" "<<result.GetDepth()<<endl;
+
+    return SameFunction(circuit, result) && result.GetBootstrapping() <= circuit.GetBootstrapping()
+        && result.GetDepth() <= circuit.GetDepth();
+}
+
+// The optimized circuit replayed on the Gate backend costs what the circuit reports
+bool TestSimulatedExecution() {
+    Circuit circuit;
+    GenericInt32<RecordedBit> a(0), b(0), c(0);
+    a.Initialize(circuit);
+    b.Initialize(circuit);
+
+    c = a / b;
+    circuit.AddOutput(c);
+
+    CircuitOptimizer optimizer;
+    Circuit result = optimizer.Optimize(circuit);
+
+    Computation computation;
+    vector<SimulatedGateBootstrappedBit> inputs(64);
+    vector<bool> bits(64);
+
+    for(int i = 0; i < 64; i++) {
+        bits[i] = (i < 32) ? (1000 >> i) % 2 : (37 >> (i - 32)) % 2;
+        inputs[i].Initialize(bits[i], computation);
+    }
+
+    vector<SimulatedGateBootstrappedBit> outputs = result.Execute(inputs);
+    vector<bool> expected = circuit.Evaluate(bits);
+    bool flag = computation.GetBootstrapping() <= result.GetBootstrapping();
+
+    for(int i = 0; i < 32; i++) {
+        flag &= outputs[i].value == expected[i];
+    }
+
+    optimizer.WriteReport(cout);
+
+    return flag;
+}
+
+// The optimized division runs on ciphertexts both gate by gate and level by level
+bool TestRealExecution() {
+    Circuit circuit;
+    GenericInt32<RecordedBit> a(0), b(0);
+    a.Initialize(circuit);
+    b.Initialize(circuit);
+    circuit.AddOutput(a / b);
+
+    CircuitOptimizer optimizer;
+    Circuit result = optimizer.Optimize(circuit);
+
+    GenericInt32<RealGateBootstrappedBit> x, y;
+    x.Initialize(1000, context);
+    y.Initialize(37, context);
+    vector<RealGateBootstrappedBit> inputs;
+    AppendBits(inputs, x);
+    AppendBits(inputs, y);
+
+    ParallelExecutor executor(context, 4);
+    vector<RealGateBootstrappedBit> sequential = result.Execute(inputs), parallel = executor.Execute(result, inputs);
+    bool flag = true;
+
+    for(int i = 0; i < 32; i++) {
+        flag &= sequential[i].Decrypt() == ((1000 / 37) >> i) % 2 && parallel[i].Decrypt() == ((1000 / 37) >> i) % 2;
+    }
+
+    return flag;
+}
+
+int main() {
+    bool flag = true;
+
+    context.Generate();
+
+    flag &= Report(TestConstantPropagation());
+    flag &= Report(TestCommonSubexpressions());
+    flag &= Report(TestNotAbsorption());
+    flag &= Report(TestOptimizedMultiplication());
+    flag &= Report(TestSimulatedExecution());
+    flag &= Report(TestRealExecution());
+    return flag ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+bool TestComparisonBool() {
+    bool flag = true;
+
+    for(int k = 0; k < 1000; k++) {
+        unsigned int p = rand() % 64, q = rand() % 64;
+        if(k % 10 == 0) {
+            p = rand();
+            q = rand();
+        }
+
+        GenericInt32<bool> a(p), b(q), low, high;
+        Comparison<bool> result = compare(a, b);
+
+        flag &= (result.less == (p < q)) && (result.equal == (p == q)) && (result.greater == (p > q));
+        flag &= ((a < b) == (p < q)) && ((a > b) == (p > q)) && ((a <= b) == (p <= q)) && ((a >= b) == (p >= q));
+        flag &= ((a == b) == (p == q)) && ((a != b) == (p != q));
+
+        low = min(a, b);
+        high = max(a, b);
+        pair<GenericInt32<bool>, GenericInt32<bool> > exchanged = compareExchange(a, b);
+        for(int i = 0; i < 32; i++) {
+            flag &= (low.encValue[i] == (((p < q ? p : q) >> i) & 1));
+            flag &= (high.encValue[i] == (((p < q ? q : p) >> i) & 1));
+            flag &= (exchanged.first.encValue[i] == low.encValue[i]) && (exchanged.second.encValue[i] == high.encValue[i]);
+        }
+    }
+
+    return flag;
+}
+
+bool TestComparison() {
+    Computation cycle;
+    GenericInt32<SimulatedGateBootstrappedBit> a(99), b(1000);
+    a.Initialize(cycle);
+    b.Initialize(cycle);
+
+    Comparison<SimulatedGateBootstrappedBit> result = compare(a, b);
+
+    return result.less.value && !result.equal.value && !result.greater.value;
+}
+
+bool TestComparisonCircuit() {
+    Computation cycle;
+    GenericInt32<SimulatedCircuitBootstrappedBit> a(99), b(99);
+    a.Initialize(cycle);
+    b.Initialize(cycle);
+
+    Comparison<SimulatedCircuitBootstrappedBit> result = compare(a, b);
+
+    return !result.less.value && result.equal.value && !result.greater.value;
+}
+
+int main(){
+    bool flag = true;
+
+    flag &= Report(TestComparisonBool());
+    flag &= Report(TestComparison());
+    flag &= Report(TestComparisonCircuit());
+
+    return flag ? 0 : 1;
+}
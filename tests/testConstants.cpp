@@ -0,0 +1,100 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+unsigned int Value(const GenericInt32<bool> &a) {
+    unsigned int ans = 0;
+
+    for(int i = 31; i >= 0; i--) {
+        ans *= 2;
+        ans += a.encValue[i];
+    }
+
+    return ans;
+}
+
+bool TestConstantsBool() {
+    int constants[8] = {0, 1, 7, 8, 100, 255, 1 << 20, -3};
+    bool flag = true;
+
+    for(int k = 0; k < 200; k++) {
+        unsigned int p = rand();
+        int q = constants[k % 8];
+        GenericInt32<bool> a(p);
+
+        flag &= (Value(a + q) == p + q);
+        flag &= (Value(a - q) == p - q);
+        flag &= (Value(a * q) == p * q);
+        flag &= (Value(a & q) == (p & q)) && (Value(a | q) == (p | q)) && (Value(a ^ q) == (p ^ q));
+        flag &= ((a == q) == (p == (unsigned int)q)) && ((a != q) == (p != (unsigned int)q));
+        flag &= ((a < q) == (p < (unsigned int)q)) && ((a > q) == (p > (unsigned int)q));
+        flag &= ((a <= q) == (p <= (unsigned int)q)) && ((a >= q) == (p >= (unsigned int)q));
+
+        if(q != 0) {
+            flag &= (Value(a / q) == p / (unsigned int)q) && (Value(a % q) == p % (unsigned int)q);
+        }
+    }
+
+    return flag;
+}
+
+// Cases 0-2 only rewire or drop bits, cases 3-6 fold the constant into the circuit and
+// cases 7-10 are the same operations with an encrypted operand
+long long Bootstraps(int operation) {
+    Computation cycle;
+    GenericInt32<SimulatedGateBootstrappedBit> a, b;
+    SimulatedGateBootstrappedBit c;
+    a.Initialize(1000, cycle);
+    b.Initialize(100, cycle);
+
+    switch(operation) {
+        case 0: b = a * 8; break;
+        case 1: b = a / 16; break;
+        case 2: b = a & 255; break;
+        case 3: b = a * 7; break;
+        case 4: b = a + 100; break;
+        case 5: c = a > 100; break;
+        case 6: c = a == 100; break;
+        case 7: b = a * b; break;
+        case 8: b = a + b; break;
+        case 9: c = a > b; break;
+        case 10: c = a == b; break;
+    }
+
+    return cycle.GetBootstrapping();
+}
+
+bool TestConstantBootstraps() {
+    // Bounds for a * 7, a + 100, a > 100 and a == 100, a little above their current counts
+    long long bounds[4] = {160, 64, 96, 32};
+    bool flag = true;
+
+    for(int i = 0; i < 3; i++) {
+        flag &= Bootstraps(i) == 0;
+    }
+
+    for(int i = 0; i < 4; i++) {
+        long long folded = Bootstraps(3 + i), encrypted = Bootstraps(7 + i);
+
+        cout<<folded<<" "<<encrypted<<" ";
+        flag &= folded <= bounds[i] && folded < encrypted;
+    }
+    cout<<endl;
+
+    return flag;
+}
+
+int main(){
+    bool flag = true;
+
+    flag &= Report(TestConstantsBool());
+    flag &= Report(TestConstantBootstraps());
+    return flag ? 0 : 1;
+}
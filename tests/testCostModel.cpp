@@ -0,0 +1,136 @@
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+bool TestOperationCounts() {
+    Computation cycle;
+    GenericInt32<SimulatedGateBootstrappedBit> a(99), b(1000), c;
+    a.Initialize(cycle);
+    b.Initialize(cycle);
+
+    c = max(a, b);
+
+    long long gates = 0;
+    for(int i = (int)Operation::And; i <= (int)Operation::OrYN; i++) {
+        gates += cycle.GetCount((Operation)i);
+    }
+
+    cout<<cycle.GetCount(Operation::And)<<" "<<cycle.GetCount(Operation::Xor)<<" "<<cycle.GetCount(Operation::Or)<<" "
+        <<cycle.GetCount(Operation::Mux)<<" "<<cycle.GetCount(Operation::Not)<<" "<<gates<<endl;
+
+    return cycle.GetCount(Operation::Encrypt) == 64 && cycle.GetEncryptions() == 64
+        && gates + 2 * cycle.GetCount(Operation::Mux) == cycle.GetBootstrapping()
+        && cycle.GetBootstrapping(CostModel::TfheGate()) == cycle.GetBootstrapping();
+}
+
+bool TestCostModels() {
+    Computation cycle;
+    GenericInt32<SimulatedGateBootstrappedBit> a(99), b(1000), c;
+    a.Initialize(cycle);
+    b.Initialize(cycle);
+
+    c = a + b;
+
+    CostModel tfhe = CostModel::TfheGate(), fhew = CostModel::Fhew(), freeXor = CostModel::FreeXor();
+
+    cout<<cycle.GetBootstrapping(tfhe)<<" "<<cycle.GetBootstrapping(fhew)<<" "<<cycle.GetBootstrapping(freeXor)<<endl;
+
+    return cycle.GetBootstrapping(freeXor) == cycle.GetBootstrapping(tfhe) - cycle.GetCount(Operation::Xor)
+        && fabs(cycle.GetTime(tfhe) - cycle.GetBootstrapping(tfhe) * tfhe.secondsPerBootstrap) < 1e-9;
+}
+
+bool TestCircuitCostModel() {
+    Circuit circuit;
+    GenericInt32<RecordedBit> a(99), b(1000), c;
+    a.Initialize(circuit);
+    b.Initialize(circuit);
+
+    c = max(a, b);
+    circuit.AddOutput(c);
+
+    return circuit.GetBootstrapping(CostModel::TfheGate()) == circuit.GetBootstrapping()
+        && circuit.GetBootstrapping(CostModel::Fhew()) == circuit.GetBootstrapping() + circuit.GetGateCount(GateType::Mux);
+}
+
+// The CSV has a header, a row per counted kind (all but copy and decrypt) and the totals
+bool TestReports() {
+    Computation cycle;
+    GenericInt8<SimulatedGateBootstrappedBit> a(9), b(10), c;
+    a.Initialize(cycle);
+    b.Initialize(cycle);
+
+    c = a * b;
+
+    vector<CostModel> models;
+    models.push_back(CostModel::TfheGate());
+    models.push_back(CostModel::FreeXor());
+
+    stringstream json, csv;
+    cycle.WriteJson(json, models);
+    cycle.WriteCsv(csv, models);
+
+    cout<<json.str();
+
+    string line;
+    int lines = 0;
+    while(getline(csv, line)) {
+        lines++;
+    }
+
+    return json.str().find("\"and\": " + to_string(cycle.GetCount(Operation::And))) != string::npos
+        && json.str().find("\"name\": \"free-xor\"") != string::npos
+        && json.str().find("copy") == string::npos && json.str().find("decrypt") == string::npos
+        && lines == operationKinds;
+}
+
+// Operations cost their mean latency at the thread count, so the run of two encryptions,
+// an AND and a MUX takes 0.05 s on one thread; mux has no row at 4 threads
+bool TestCalibratedModel() {
+    stringstream calibration;
+    calibration<<"# operation threads mean stddev p50 p90 p99 throughput"<<endl;
+
+    for(int i = 0; i < operationKinds; i++) {
+        const char *name = OperationName((Operation)i);
+
+        calibration<<name<<" 1 "<<(i == (int)Operation::Mux ? 0.02 : 0.01)<<" 0.001 0.01 0.011 0.012 100"<<endl;
+
+        if(i != (int)Operation::Mux) {
+            calibration<<name<<" 4 0.012 0.001 0.012 0.013 0.014 320"<<endl;
+        }
+    }
+
+    CostModel single = CostModel::FreeXor(), parallel = CostModel::FreeXor();
+    bool singleRead = CostModel::Calibrated(calibration, 1, single);
+    calibration.clear();
+    calibration.seekg(0);
+    bool parallelRead = CostModel::Calibrated(calibration, 4, parallel);
+
+    Computation cycle;
+    SimulatedGateBootstrappedBit a, b, c;
+    a.Initialize(1, cycle);
+    b.Initialize(0, cycle);
+    c = mux(a, a & b, b);
+
+    return singleRead && fabs(single.seconds[(int)Operation::And] - 0.01) < 1e-9 && fabs(single.seconds[(int)Operation::Mux] - 0.02) < 1e-9
+        && single.name == "calibrated-1" && fabs(cycle.GetTime(single) - 0.05) < 1e-9
+        && !parallelRead && parallel.name == "free-xor";
+}
+
+int main() {
+    bool flag = true;
+
+    flag &= Report(TestOperationCounts());
+    flag &= Report(TestCostModels());
+    flag &= Report(TestCircuitCostModel());
+    flag &= Report(TestReports());
+    flag &= Report(TestCalibratedModel());
+    return flag ? 0 : 1;
+}
@@ -4,6 +4,7 @@
 #include <tfhe/tfhe.h>
 #include <tfhe/tfhe_io.h>
 #include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
 
 using namespace std;
 using namespace homomorphicEvaluation;
@@ -43,8 +44,6 @@ bool TestDivision(){
         real /= 2;
     }
 
-    cout<<cycle.GetBootstrapping()<<endl;
-
     return flag;
 }
 
@@ -66,15 +65,39 @@ bool TestDivisionCircuit() {
         real /= 2;
     }
 
-    cout<<cycle.GetBootstrapping()<<endl;
+    return flag;
+}
+
+bool TestDivModQuotient() {
+    bool flag = true;
+
+    for(int k = 0; k < 200; k++) {
+        unsigned int p = rand(), q = (k % 2) ? rand() % 1000 + 1 : rand() + 1;
+        if(k == 0) {
+            q = 0;
+        }
+
+        GenericInt32<bool> a(p), b(q), c;
+
+        c = divmod(a, b).first;
+        // Division by zero gives all ones as quotient and the dividend as remainder
+        unsigned int real = q ? p / q : 4294967295u;
+
+        for(int i = 0; i < 32; i++) {
+            flag &= (c.encValue[i] == ((real >> i) & 1));
+        }
+    }
 
     return flag;
 }
 
 int main(){
-    cout<<TestDivisionBool()<<endl;
-    cout<<TestDivision()<<endl;
-    cout<<TestDivisionCircuit()<<endl;
+    bool flag = true;
+
+    flag &= Report(TestDivisionBool());
+    flag &= Report(TestDivision());
+    flag &= Report(TestDivisionCircuit());
+    flag &= Report(TestDivModQuotient());
 
-    return 0;
+    return flag ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/encryptedColumn.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+FheContext context;
+
+template <int N>
+long long Decrypt(const GenericInt<N, RealGateBootstrappedBit> &a) {
+    long long ans = 0;
+
+    for(int i = N - 1; i >= 0; i--) {
+        ans *= 2;
+        ans += a.encValue[i].Decrypt();
+    }
+
+    return ans;
+}
+
+bool WriteColumn(const string &path, const vector<int> &values) {
+    EncryptedColumnWriter<32> writer;
+
+    if(!writer.Open(path, context, 16)) {
+        return false;
+    }
+
+    for(size_t i = 0; i < values.size(); i++) {
+        GenericInt32<RealGateBootstrappedBit> a;
+        a.Initialize(values[i], context);
+        writer.Append(a);
+    }
+
+    // Public constants are stored as trivial encryptions
+    writer.Append(GenericInt32<RealGateBootstrappedBit>(7));
+
+    return writer.Close();
+}
+
+bool TestColumnRoundTrip() {
+    vector<int> values;
+    for(int i = 0; i < 50; i++) {
+        values.push_back(rand() % 100000);
+    }
+
+    if(!WriteColumn("testEncryptedColumn.col", values)) {
+        return false;
+    }
+
+    EncryptedColumnReader<32> reader;
+    bool flag = reader.Open("testEncryptedColumn.col", context) && reader.GetCount() == values.size() + 1;
+
+    for(size_t i = 0; flag && i < values.size(); i++) {
+        GenericInt32<RealGateBootstrappedBit> a = reader.Read(i);
+        flag &= a.encValue[0].borrowed && Decrypt(a) == values[i];
+    }
+
+    flag &= Decrypt(reader.Read(values.size())) == 7;
+
+    reader.Close();
+    remove("testEncryptedColumn.col");
+
+    return flag;
+}
+
+// Borrowed records feed gates like any other bits, and a released chunk can be read again
+bool TestColumnEvaluation() {
+    vector<int> values;
+    for(int i = 0; i < 40; i++) {
+        values.push_back(rand() % 1000);
+    }
+
+    if(!WriteColumn("testEncryptedColumn.col", values)) {
+        return false;
+    }
+
+    EncryptedColumnReader<32> reader;
+    bool flag = reader.Open("testEncryptedColumn.col", context);
+    GenericInt32<RealGateBootstrappedBit> sum(0);
+    long long expected = 0;
+
+    for(size_t i = 0; flag && i < values.size(); i++) {
+        sum = sum + reader.Read(i);
+        expected += values[i];
+
+        if(i % 16 == 15) {
+            reader.ReleaseChunk(i / 16);
+        }
+    }
+
+    flag &= Decrypt(sum) == expected && Decrypt(reader.Read(3)) == values[3];
+
+    reader.Close();
+    remove("testEncryptedColumn.col");
+
+    return flag;
+}
+
+bool TestColumnRejectsMismatch() {
+    vector<int> values(3, 1);
+
+    if(!WriteColumn("testEncryptedColumn.col", values)) {
+        return false;
+    }
+
+    EncryptedColumnReader<16> narrow;
+    bool opened = narrow.Open("testEncryptedColumn.col", context);
+    remove("testEncryptedColumn.col");
+
+    EncryptedColumnReader<32> missing;
+
+    return !opened && !missing.Open("testEncryptedColumn.missing", context) && missing.GetCount() == 0;
+}
+
+// Rewrites the header of a good column and checks that the reader refuses it
+bool OpensCorrupted(void (*corrupt)(ColumnHeader &header), long long size) {
+    vector<int> values(20, 5);
+
+    if(!WriteColumn("testEncryptedColumn.col", values)) {
+        return true;
+    }
+
+    ColumnHeader header;
+    FILE *file = fopen("testEncryptedColumn.col", "r+b");
+    bool read = fread(&header, sizeof(header), 1, file) == 1;
+
+    corrupt(header);
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+    fclose(file);
+
+    if(size >= 0 && truncate("testEncryptedColumn.col", size) != 0) {
+        read = false;
+    }
+
+    EncryptedColumnReader<32> reader;
+    bool opened = reader.Open("testEncryptedColumn.col", context);
+    remove("testEncryptedColumn.col");
+
+    return !read || opened;
+}
+
+void EmptyChunks(ColumnHeader &header) { header.chunkBytes = 0; }
+void ShortChunks(ColumnHeader &header) { header.chunkBytes = 4096; }
+void UnalignedData(ColumnHeader &header) { header.dataOffset = 4100; }
+void UnalignedChunks(ColumnHeader &header) { header.chunkBytes += 8; }
+void OverflowingCount(ColumnHeader &header) { header.recordCount = 0xFFFFFFFFFFFFFFF0ULL; }
+
+bool TestColumnRejectsCorruptHeader() {
+    return !OpensCorrupted(EmptyChunks, 8192) && !OpensCorrupted(ShortChunks, -1) && !OpensCorrupted(UnalignedData, -1)
+        && !OpensCorrupted(UnalignedChunks, -1) && !OpensCorrupted(OverflowingCount, -1);
+}
+
+int main() {
+    bool flag = true;
+
+    context.Generate();
+
+    flag &= Report(TestColumnRoundTrip());
+    flag &= Report(TestColumnEvaluation());
+    flag &= Report(TestColumnRejectsMismatch());
+    flag &= Report(TestColumnRejectsCorruptHeader());
+    return flag ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/encryptedSearch.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+template <int N>
+long long Value(const GenericInt<N, bool> &a) {
+    long long value = 0;
+
+    for(int i = N - 1; i >= 0; i--) {
+        value = value * 2 + a.encValue[i];
+    }
+
+    return value;
+}
+
+// A thousand-way OR is ten levels deep, with one gate fewer than it has inputs
+bool TestReductionTrees() {
+    Circuit circuit;
+    vector<RecordedBit> bits(1000);
+    bool flag = true;
+
+    for(int i = 0; i < 1000; i++) {
+        bits[i].Initialize(0, circuit);
+    }
+
+    circuit.AddOutput(orTree(bits));
+    circuit.AddOutput(andTree(bits));
+
+    flag &= circuit.GetDepth() == 10 && circuit.GetGateCount() == 2 * 999;
+
+    for(int n = 0; n < 40; n++) {
+        vector<bool> values(n);
+        bool any = false, all = true;
+
+        for(int i = 0; i < n; i++) {
+            values[i] = rand() % 8 != 0;
+            any |= values[i];
+            all &= values[i];
+        }
+
+        flag &= orTree(values) == any && andTree(values) == all;
+    }
+
+    return flag;
+}
+
+// Membership over encrypted and public records agrees with a plain search, and against
+// public values the shared literals need far fewer gates
+bool TestMembership() {
+    vector<GenericInt32<bool> > records;
+    vector<unsigned long long> values;
+    bool flag = true;
+
+    for(int i = 0; i < 300; i++) {
+        values.push_back(rand() % 5000);
+        records.push_back(GenericInt32<bool>(values[i]));
+    }
+
+    for(int k = 0; k < 20; k++) {
+        int key = k < 10 ? values[rand() % 300] : rand() % 5000;
+        bool expected = false;
+
+        for(int i = 0; i < 300; i++) {
+            expected |= (int)values[i] == key;
+        }
+
+        vector<bool> equal = equalAll(GenericInt32<bool>(key), values);
+
+        flag &= contains(GenericInt32<bool>(key), records) == expected && contains(GenericInt32<bool>(key), values) == expected;
+
+        for(int i = 0; i < 300; i++) {
+            flag &= equal[i] == ((int)values[i] == key);
+        }
+    }
+
+    Computation encrypted, shared;
+    vector<GenericInt32<SimulatedGateBootstrappedBit> > table(300);
+    GenericInt32<SimulatedGateBootstrappedBit> x, y;
+    x.Initialize(values[7], encrypted);
+    y.Initialize(values[7], shared);
+
+    for(int i = 0; i < 300; i++) {
+        table[i].Initialize(values[i], encrypted);
+    }
+
+    flag &= contains(x, table).value && contains(y, values).value;
+
+    cout<<encrypted.GetBootstrapping()<<" "<<shared.GetBootstrapping()<<endl;
+
+    return flag && shared.GetBootstrapping() * 4 < encrypted.GetBootstrapping();
+}
+
+// Membership of an encrypted key in ten thousand encrypted records stays logarithmically deep
+bool TestMembershipDepth() {
+    Circuit circuit;
+    vector<GenericInt32<RecordedBit> > records(10000);
+    GenericInt32<RecordedBit> key;
+    key.Initialize(circuit);
+
+    for(int i = 0; i < 10000; i++) {
+        records[i].Initialize(0, circuit);
+    }
+
+    circuit.AddOutput(contains(key, records));
+
+    cout<<circuit.GetBootstrapping()<<" "<<circuit.GetDepth()<<endl;
+
+    // One XNOR, five levels of AND over 32 bits and fourteen of OR over 10000 records
+    return circuit.GetDepth() == 1 + 5 + 14;
+}
+
+bool TestLookup() {
+    bool flag = true;
+
+    for(int n = 1; n <= 13; n++) {
+        vector<GenericInt<16, bool> > table(n);
+
+        for(int i = 0; i < n; i++) {
+            table[i] = GenericInt<16, bool>(rand() % 60000);
+        }
+
+        for(int index = 0; index < 16; index++) {
+            flag &= Value(lookup(table, GenericInt<4, bool>(index))) == (index < n ? Value(table[index]) : 0);
+        }
+
+        // A two-bit index only reaches the first four entries
+        flag &= Value(lookup(table, GenericInt<2, bool>(3))) == (3 < n ? Value(table[3]) : 0);
+    }
+
+    Circuit circuit;
+    vector<GenericInt32<RecordedBit> > table(1024);
+    GenericInt<10, RecordedBit> index;
+    index.Initialize(circuit);
+
+    for(int i = 0; i < 1024; i++) {
+        table[i].Initialize(0, circuit);
+    }
+
+    circuit.AddOutput(lookup(table, index));
+
+    return flag && circuit.GetDepth() == 10 && circuit.GetGateCount(GateType::Mux) == 1023 * 32;
+}
+
+// A public table folds the first level of MUXes into free literals of the index
+bool TestPublicLookup() {
+    Computation cycle;
+    vector<unsigned long long> table(64);
+    GenericInt<6, SimulatedGateBootstrappedBit> index(0);
+    index.Initialize(45, cycle);
+
+    for(int i = 0; i < 64; i++) {
+        table[i] = (i * 37) % 256;
+    }
+
+    GenericInt<8, SimulatedGateBootstrappedBit> result = lookup<8>(table, index);
+    int value = 0;
+
+    for(int i = 7; i >= 0; i--) {
+        value = value * 2 + result.encValue[i].value;
+    }
+
+    cout<<cycle.GetBootstrapping()<<endl;
+
+    return value == (45 * 37) % 256 && cycle.GetBootstrapping() < 31 * 8 * 2;
+}
+
+int main() {
+    bool flag = true;
+
+    flag &= Report(TestReductionTrees());
+    flag &= Report(TestMembership());
+    flag &= Report(TestMembershipDepth());
+    flag &= Report(TestLookup());
+    flag &= Report(TestPublicLookup());
+    return flag ? 0 : 1;
+}
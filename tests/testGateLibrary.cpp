@@ -0,0 +1,166 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/circuitOptimizer.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+FheContext context;
+
+bool Expected(Operation operation, bool a, bool b) {
+    switch(operation) {
+        case Operation::Xnor: return !(a ^ b);
+        case Operation::Nand: return !(a & b);
+        case Operation::Nor: return !(a | b);
+        case Operation::AndNY: return !a & b;
+        case Operation::AndYN: return a & !b;
+        case Operation::OrNY: return !a | b;
+        case Operation::OrYN: return a | !b;
+        default: return false;
+    }
+}
+
+template <class BoolType>
+BoolType CallGate(Operation operation, const BoolType &a, const BoolType &b) {
+    switch(operation) {
+        case Operation::Xnor: return xnor(a, b);
+        case Operation::Nand: return nand(a, b);
+        case Operation::Nor: return nor(a, b);
+        case Operation::AndNY: return andny(a, b);
+        case Operation::AndYN: return andyn(a, b);
+        case Operation::OrNY: return orny(a, b);
+        default: return oryn(a, b);
+    }
+}
+
+// Every new gate matches its truth table on every bit type and costs one bootstrap
+bool TestTruthTables() {
+    bool flag = true;
+
+    for(int i = (int)Operation::Xnor; i <= (int)Operation::OrYN; i++) {
+        Operation operation = (Operation)i;
+
+        for(int a = 0; a < 2; a++) {
+            for(int b = 0; b < 2; b++) {
+                bool expected = Expected(operation, a, b);
+                Computation gateCycle, circuitCycle, levelledCycle;
+                Circuit circuit;
+
+                SimulatedGateBootstrappedBit x, y;
+                x.Initialize(a, gateCycle);
+                y.Initialize(b, gateCycle);
+
+                SimulatedCircuitBootstrappedBit u, v;
+                u.Initialize(a, circuitCycle);
+                v.Initialize(b, circuitCycle);
+
+                SimulatedLevelledBit p, q;
+                p.Initialize(a, 4, levelledCycle);
+                q.Initialize(b, 4, levelledCycle);
+
+                RecordedBit r, s;
+                r.Initialize(a, circuit);
+                s.Initialize(b, circuit);
+                circuit.AddOutput(CallGate(operation, r, s));
+
+                RealGateBootstrappedBit e, f;
+                e.Initialize(a, context);
+                f.Initialize(b, context);
+
+                vector<bool> inputs;
+                inputs.push_back(a);
+                inputs.push_back(b);
+
+                flag &= CallGate(operation, (bool)a, (bool)b) == expected;
+                flag &= CallGate(operation, x, y).value == expected && gateCycle.GetBootstrapping() == 1 && gateCycle.GetCount(operation) == 1;
+                flag &= CallGate(operation, u, v).value == expected && circuitCycle.GetBootstrapping() == 1;
+                flag &= CallGate(operation, p, q).value == expected && levelledCycle.GetBootstrapping() == 0;
+                flag &= circuit.Evaluate(inputs)[0] == expected && circuit.GetBootstrapping() == 1;
+                flag &= CallGate(operation, e, f).Decrypt() == expected;
+                flag &= CallGate(operation, e, RealGateBootstrappedBit(b)).Decrypt() == expected;
+            }
+        }
+    }
+
+    return flag;
+}
+
+// Complemented operands map onto the gate library, so subtraction and equality need no NOT
+// beyond the one on the lowest difference bit, a ^ !b ^ 1
+bool TestMappedOperators() {
+    Computation cycle;
+    GenericInt32<SimulatedGateBootstrappedBit> a(1000), b(99), c;
+    a.Initialize(cycle);
+    b.Initialize(cycle);
+
+    c = a - b;
+    SimulatedGateBootstrappedBit equal = a == b;
+
+    cout<<cycle.GetBootstrapping()<<" "<<cycle.GetCount(Operation::Xnor)<<" "<<cycle.GetCount(Operation::AndYN)<<" "
+        <<cycle.GetCount(Operation::Nor)<<" "<<cycle.GetCount(Operation::Not)<<endl;
+
+    bool flag = cycle.GetCount(Operation::Not) == 1 && !equal.value;
+
+    for(int i = 0; i < 32; i++) {
+        flag &= c.encValue[i].value == ((901 >> i) & 1);
+    }
+
+    return flag;
+}
+
+bool TestTechnologyMapping() {
+    Circuit circuit;
+    int x = circuit.AddInput(), y = circuit.AddInput();
+    int notX = circuit.AddGate(GateType::Not, x);
+
+    circuit.outputs.push_back(circuit.AddGate(GateType::And, notX, y));
+    circuit.outputs.push_back(circuit.AddGate(GateType::Xor, notX, y));
+    circuit.outputs.push_back(circuit.AddGate(GateType::Not, circuit.AddGate(GateType::Or, x, y)));
+
+    CircuitOptimizer optimizer;
+    Circuit result = optimizer.EliminateDeadGates(optimizer.MapGates(circuit));
+    bool flag = result.GetGateCount() == 3 && result.GetGateCount(GateType::Not) == 0
+        && result.GetGateCount(GateType::AndNY) == 1 && result.GetGateCount(GateType::Xnor) == 1 && result.GetGateCount(GateType::Nor) == 1;
+
+    for(int i = 0; i < 4; i++) {
+        vector<bool> inputs;
+        inputs.push_back(i & 1);
+        inputs.push_back(i >> 1);
+        flag &= circuit.Evaluate(inputs) == result.Evaluate(inputs);
+    }
+
+    return flag;
+}
+
+bool TestLevelledMux() {
+    Computation cycle;
+    GenericInt32<SimulatedLevelledBit> a(0), b(0), c;
+    a.Initialize(99, 8, cycle);
+    b.Initialize(1000, 8, cycle);
+
+    c = max(a, b);
+
+    bool flag = true;
+    for(int i = 0; i < 32; i++) {
+        flag &= c.encValue[i].value == ((1000 >> i) & 1);
+    }
+
+    return flag && cycle.GetCount(Operation::Mux) >= 32;
+}
+
+int main() {
+    bool flag = true;
+
+    context.Generate();
+
+    flag &= Report(TestTruthTables());
+    flag &= Report(TestMappedOperators());
+    flag &= Report(TestTechnologyMapping());
+    flag &= Report(TestLevelledMux());
+    return flag ? 0 : 1;
+}
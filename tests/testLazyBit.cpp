@@ -0,0 +1,103 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/lazyBit.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+FheContext context;
+
+template <int N>
+long long Value(const GenericInt<N, bool> &a) {
+    long long value = 0;
+
+    for(int i = N - 1; i >= 0; i--) {
+        value = value * 2 + a.encValue[i];
+    }
+
+    return value;
+}
+
+// The serial search loop of simulations/Searching.cpp, unchanged: the comparisons with
+// every record are independent, so the batch needs a few waves for hundreds of gates
+bool TestSerialSearch() {
+    WorkStealingPool pool(4);
+    LazyScheduler<bool> scheduler(pool);
+    vector<GenericInt32<LazyBit<bool> > > a(32);
+    GenericInt32<LazyBit<bool> > x = MakeLazy(GenericInt32<bool>(1234), scheduler);
+    LazyBit<bool> result(0);
+
+    for(int i = 0; i < 32; i++) {
+        a[i] = MakeLazy(GenericInt32<bool>(i == 17 ? 1234 : rand() % 1000), scheduler);
+    }
+
+    for(int i = 0; i < 32; i++) {
+        result = result | (x == a[i]);
+    }
+
+    bool pendingBefore = !result.IsReady() && scheduler.GetPendingCount() > 0;
+    bool found = result.Get();
+
+    cout<<scheduler.GetNodeCount()<<" "<<scheduler.GetWaveCount()<<endl;
+
+    return pendingBefore && found && scheduler.GetBatchCount() == 1 && scheduler.GetWaveCount() * 10 < scheduler.GetNodeCount();
+}
+
+// A small batch size flushes while the expression is still being built
+bool TestBatching() {
+    WorkStealingPool pool(4);
+    LazyScheduler<bool> scheduler(pool, 100);
+    GenericInt32<LazyBit<bool> > x = MakeLazy(GenericInt32<bool>(123456), scheduler);
+    GenericInt32<LazyBit<bool> > y = MakeLazy(GenericInt32<bool>(789), scheduler);
+
+    GenericInt32<LazyBit<bool> > product = x * y;
+    bool bounded = scheduler.GetPendingCount() < 100 && scheduler.GetBatchCount() > 1;
+
+    return bounded && Value(Resolve(product)) == (123456LL * 789) % 4294967296LL && scheduler.GetPendingCount() == 0;
+}
+
+// Gates between public constants do not wait for a scheduler
+bool TestConstants() {
+    LazyBit<bool> a(1), b(0);
+    LazyBit<bool> c = mux(a, b, !b) ^ (a & b);
+
+    return c.IsReady() && c.Get() == false && xnor(a, b).Get() == false;
+}
+
+bool TestRealBits() {
+    WorkStealingPool pool(4);
+    LazyScheduler<RealGateBootstrappedBit> scheduler(pool);
+    GenericInt32<RealGateBootstrappedBit> a, b;
+    a.Initialize(1000, context);
+    b.Initialize(99, context);
+
+    GenericInt32<LazyBit<RealGateBootstrappedBit> > x = MakeLazy(a, scheduler), y = MakeLazy(b, scheduler);
+    GenericInt32<LazyBit<RealGateBootstrappedBit> > sum = x + y;
+    LazyBit<RealGateBootstrappedBit> greater = x > y;
+
+    GenericInt32<RealGateBootstrappedBit> result = Resolve(sum);
+    int ans = 0;
+
+    for(int i = 31; i >= 0; i--) {
+        ans = ans * 2 + result.encValue[i].Decrypt();
+    }
+
+    return ans == 1099 && greater.Decrypt() && scheduler.GetBatchCount() == 1;
+}
+
+int main() {
+    bool flag = true;
+
+    context.Generate();
+
+    flag &= Report(TestSerialSearch());
+    flag &= Report(TestBatching());
+    flag &= Report(TestConstants());
+    flag &= Report(TestRealBits());
+    return flag ? 0 : 1;
+}
@@ -4,6 +4,7 @@
 #include <tfhe/tfhe.h>
 #include <tfhe/tfhe_io.h>
 #include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
 
 using namespace std;
 using namespace homomorphicEvaluation;
@@ -43,9 +44,6 @@ bool TestMultiplication() {
         real /= 2;
     }
 
-     cout<<cycle.GetBootstrapping()<<endl;
-
-
     return flag;
 }
 
@@ -68,16 +66,49 @@ bool TestMultiplicationCircuit() {
         real /= 2;
     }
 
-     cout<<cycle.GetBootstrapping()<<endl;
+    return flag;
+}
 
+bool TestMultiplierTypes() {
+    MultiplierType types[4] = {MultiplierType::Array, MultiplierType::Wallace, MultiplierType::Dadda, MultiplierType::Karatsuba};
+    bool flag = true;
+
+    for(int t = 0; t < 4; t++) {
+        Circuit circuit;
+        GenericInt32<RecordedBit> x, y;
+        x.multiplier = types[t];
+        x.Initialize(circuit);
+        y.Initialize(circuit);
+        circuit.AddOutput(x * y);
+
+        cout<<circuit.GetBootstrapping()<<" "<<circuit.GetDepth()<<endl;
+
+        for(int k = 0; k < 100; k++) {
+            int p = rand(), q = rand();
+            GenericInt32<bool> a(p), b(q), c, d;
+            a.multiplier = MultiplierType::Array;
+            b.multiplier = types[t];
+
+            c = a * b;
+            d = b * a;
+
+            for(int i = 0; i < 32; i++) {
+                flag &= (c.encValue[i] == d.encValue[i]);
+                flag &= (c.encValue[i] == ((((unsigned int)p * (unsigned int)q) >> i) & 1));
+            }
+        }
+    }
 
     return flag;
 }
 
 int main(){
-    cout<<TestMultiplicationBool()<<endl;
-    cout<<TestMultiplication()<<endl;
-    cout<<TestMultiplicationCircuit()<<endl;
+    bool flag = true;
+
+    flag &= Report(TestMultiplicationBool());
+    flag &= Report(TestMultiplication());
+    flag &= Report(TestMultiplicationCircuit());
+    flag &= Report(TestMultiplierTypes());
 
-    return 0;
+    return flag ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/parallelExecutor.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+FheContext context;
+
+int Decrypt(const GenericInt32<RealGateBootstrappedBit> &a) {
+    int ans = 0;
+
+    for(int i = 31; i >= 0; i--) {
+        ans *= 2;
+        ans += a.encValue[i].Decrypt();
+    }
+
+    return ans;
+}
+
+bool TestParallelAddition() {
+    Circuit circuit;
+    GenericInt32<RecordedBit> x, y;
+    x.Initialize(circuit);
+    y.Initialize(circuit);
+    circuit.AddOutput(x + y);
+
+    GenericInt32<RealGateBootstrappedBit> a, b;
+    a.Initialize(99, context);
+    b.Initialize(1000, context);
+    vector<RealGateBootstrappedBit> inputs;
+    AppendBits(inputs, a);
+    AppendBits(inputs, b);
+
+    ParallelExecutor executor(context);
+    vector<RealGateBootstrappedBit> outputs = executor.Execute(circuit, inputs);
+
+    return Decrypt(ExtractInt<32>(outputs, 0)) == 1099;
+}
+
+bool TestParallelComparison() {
+    Circuit circuit;
+    GenericInt32<RecordedBit> x, y;
+    x.Initialize(circuit);
+    y.Initialize(circuit);
+    circuit.AddOutput(x > y);
+    circuit.AddOutput(!(x == y));
+
+    GenericInt32<RealGateBootstrappedBit> a, b;
+    a.Initialize(1000, context);
+    b.Initialize(99, context);
+    vector<RealGateBootstrappedBit> inputs;
+    AppendBits(inputs, a);
+    AppendBits(inputs, b);
+
+    ParallelExecutor executor(context, 4);
+    vector<RealGateBootstrappedBit> outputs = executor.Execute(circuit, inputs);
+
+    return outputs[0].Decrypt() && outputs[1].Decrypt();
+}
+
+int main(){
+    bool flag = true;
+
+    context.Generate();
+
+    flag &= Report(TestParallelAddition());
+    flag &= Report(TestParallelComparison());
+
+    return flag ? 0 : 1;
+}
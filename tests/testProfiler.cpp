@@ -0,0 +1,93 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+// Depth and gate counts of a profiled expression match the circuit RecordedBit builds for it
+bool TestProfileMatchesCircuit() {
+    Computation computation;
+    Circuit circuit;
+    GenericInt32<ProfiledBit> a(0), b(0), c;
+    GenericInt32<RecordedBit> x(0), y(0);
+    a.Initialize(1234, computation);
+    b.Initialize(567, computation);
+    x.Initialize(circuit);
+    y.Initialize(circuit);
+
+    c = a * b;
+    circuit.AddOutput(x * y);
+
+    long long gates = 0;
+
+    for(long long i = 1; i <= computation.GetDepth(); i++) {
+        gates += computation.GetWidth(i);
+    }
+
+    bool flag = computation.GetDepth() == circuit.GetDepth() && gates == circuit.GetGateCount() - circuit.GetGateCount(GateType::Not)
+        && computation.GetBootstrapping() == circuit.GetBootstrapping();
+
+    for(int i = 0; i < 32; i++) {
+        flag &= c.encValue[i].value == (((1234 * 567) >> i) & 1);
+    }
+
+    return flag;
+}
+
+// A ripple-carry addition is one long chain, a Kogge-Stone one is wide and shallow
+bool TestWidthAndDepth() {
+    Computation ripple, prefix;
+    GenericInt32<ProfiledBit> a(0), b(0), c(0), d(0), e;
+    a.adder = AdderType::RippleCarry;
+    c.adder = AdderType::KoggeStone;
+    a.Initialize(99, ripple);
+    b.Initialize(1000, ripple);
+    c.Initialize(99, prefix);
+    d.Initialize(1000, prefix);
+
+    e = a + b;
+    e = c + d;
+
+    cout<<ripple.GetDepth()<<" "<<ripple.GetPeakWidth()<<" "<<prefix.GetDepth()<<" "<<prefix.GetPeakWidth()<<endl;
+
+    return prefix.GetDepth() < ripple.GetDepth() && prefix.GetPeakWidth() >= ripple.GetPeakWidth()
+        && prefix.GetAverageWidth() > ripple.GetAverageWidth();
+}
+
+// One core takes as long as the whole computation; enough cores take one gate time per level
+bool TestMakespan() {
+    Computation computation;
+    GenericInt<8, ProfiledBit> a(0), b(0), c;
+    a.Initialize(100, computation);
+    b.Initialize(7, computation);
+
+    c = a * b;
+
+    CostModel model = CostModel::FreeXor();
+    double single = computation.GetMakespan(model, 1), dual = computation.GetMakespan(model, 2);
+    double unlimited = computation.GetMakespan(model, computation.GetPeakWidth());
+    vector<int> cores;
+    cores.push_back(1);
+    cores.push_back(4);
+    cores.push_back(16);
+
+    computation.WriteProfile(cout, model, cores);
+
+    return fabs(single - computation.GetTime(model)) < 1e-6 && dual < single && dual >= single / 2 - 1e-9
+        && unlimited <= computation.GetMakespan(model, 16) && computation.GetMakespan(model, 1000000) == unlimited;
+}
+
+int main() {
+    bool flag = true;
+
+    flag &= Report(TestProfileMatchesCircuit());
+    flag &= Report(TestWidthAndDepth());
+    flag &= Report(TestMakespan());
+    return flag ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+FheContext context;
+
+bool TestRealGates() {
+    RealGateBootstrappedBit a, b;
+    a.Initialize(1, context);
+    b.Initialize(0, context);
+
+    return (a & b).Decrypt() == 0 && (a | b).Decrypt() == 1 && (a ^ b).Decrypt() == 1
+        && (!a).Decrypt() == 0 && mux(a, b, a).Decrypt() == 0 && mux(b, RealGateBootstrappedBit(1), a).Decrypt() == 1;
+}
+
+// Gates against public constants fold to copies and negations without a bootstrap
+bool TestConstantFolding() {
+    RealGateBootstrappedBit a, zero(0), one(1);
+    a.Initialize(1, context);
+
+    return (a & zero).value == NULL && (a | one).value == NULL && (zero ^ one).value == NULL
+        && (a & one).Decrypt() == 1 && (a ^ one).Decrypt() == 0 && (a | zero).Decrypt() == 1
+        && mux(one, zero, a).value == NULL && mux(a, one, zero).Decrypt() == 1 && zero.Decrypt() == 0;
+}
+
+bool TestMoveAndCopy() {
+    RealGateBootstrappedBit a, b;
+    a.Initialize(1, context);
+    b.Initialize(0, context);
+    LweSample *buffer = a.value;
+
+    RealGateBootstrappedBit c(std::move(a));
+    RealGateBootstrappedBit d(c);
+
+    b = std::move(c);
+    d = b;
+
+    return a.value == NULL && b.value == buffer && d.value != buffer && b.Decrypt() == 1 && d.Decrypt() == 1;
+}
+
+// Temporaries go back to the arena, so a loop of gates settles at a fixed pool size
+bool TestArenaReuse() {
+    GenericInt8<RealGateBootstrappedBit> a, b, c;
+    a.Initialize(9, context);
+    b.Initialize(10, context);
+    size_t before = 0;
+
+    for(int k = 0; k < 3; k++) {
+        c = a + b;
+
+        if(k == 1) {
+            before = context.arena.GetFreeCount();
+        }
+    }
+
+    int result = 0;
+    for(int i = 0; i < 8; i++) {
+        result += c.encValue[i].Decrypt() << i;
+    }
+
+    return result == 19 && context.arena.GetFreeCount() == before;
+}
+
+template <int N>
+int Value(const GenericInt<N, RealGateBootstrappedBit> &a) {
+    int value = 0;
+
+    for(int i = N - 1; i >= 0; i--) {
+        value = value * 2 + a.encValue[i].Decrypt();
+    }
+
+    return value;
+}
+
+// Public constants have no ciphertext, so assigning one must still copy its value
+bool TestPublicOperands() {
+    RealGateBootstrappedBit one(1), x(0);
+    x = one;
+
+    GenericInt8<RealGateBootstrappedBit> a, c(5), e;
+    a.Initialize(9, context);
+    e = c;
+
+    return x.Decrypt() == 1 && x.value == NULL && Value(a + c) == 14 && Value(a * c) == 45 && Value(c + a) == 14
+        && Value(e) == 5 && Value(c.ZeroExtend<16>()) == 5;
+}
+
+// The evaluator only loads the cloud key: it can compute on the client's ciphertexts but
+// cannot read them, and the client decrypts the result
+bool TestCloudKeyRoundTrip() {
+    FheContext evaluator;
+
+    if(!context.SaveCloudKey("testRealBit.cloud") || !evaluator.LoadCloudKey("testRealBit.cloud")) {
+        return false;
+    }
+    remove("testRealBit.cloud");
+
+    RealGateBootstrappedBit a, b, c;
+    a.Initialize(1, context);
+    b.Initialize(1, context);
+
+    RealGateBootstrappedBit x(evaluator, uninitialized), result(context, uninitialized);
+    bootsCOPY(x.value, a.value, evaluator.cloudKey);
+    c = x & b;
+    bootsCOPY(result.value, c.value, evaluator.cloudKey);
+
+    return !evaluator.HasSecretKey() && evaluator.secretKey == NULL && context.HasSecretKey() && result.Decrypt() == 1;
+}
+
+int main() {
+    bool flag = true;
+
+    context.Generate();
+
+    flag &= Report(TestRealGates());
+    flag &= Report(TestConstantFolding());
+    flag &= Report(TestMoveAndCopy());
+    flag &= Report(TestArenaReuse());
+    flag &= Report(TestPublicOperands());
+    flag &= Report(TestCloudKeyRoundTrip());
+    return flag ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+vector<bool> InputBits(int x, int y) {
+    vector<bool> bits;
+
+    for(int i = 0; i < 32; i++) {
+        bits.push_back(x % 2);
+        x /= 2;
+    }
+
+    for(int i = 0; i < 32; i++) {
+        bits.push_back(y % 2);
+        y /= 2;
+    }
+
+    return bits;
+}
+
+bool CheckBits(const vector<bool> &bits, int real) {
+    bool flag = (bits.size() == 32);
+
+    for(int i = 0; i < 32 && flag; i++) {
+        flag &= (bits[i] == (real%2));
+
+        real /= 2;
+    }
+
+    return flag;
+}
+
+bool TestRecordingAddition() {
+    Circuit circuit;
+    GenericInt32<RecordedBit> a(99), b(1000), c(0);
+    a.Initialize(circuit);
+    b.Initialize(circuit);
+
+    c = a + b;
+    circuit.AddOutput(c);
+
+    cout<<circuit.GetGateCount()<<" "<<circuit.GetDepth()<<endl;
+
+    return CheckBits(circuit.Evaluate(InputBits(99, 1000)), 1099) && CheckBits(circuit.Evaluate(InputBits(12345, 678)), 13023);
+}
+
+bool TestRecordingMultiplication() {
+    Circuit circuit;
+    GenericInt32<RecordedBit> a(99), b(1000), c(0);
+    a.Initialize(circuit);
+    b.Initialize(circuit);
+
+    c = b * a;
+    circuit.AddOutput(c);
+
+    cout<<circuit.GetGateCount()<<" "<<circuit.GetDepth()<<endl;
+
+    bool flag = true;
+    for(int i = 0; i < 32; i++) {
+        flag &= (c.encValue[i].value == ((1000 * 99) >> i) % 2);
+    }
+
+    return flag && CheckBits(circuit.Evaluate(InputBits(99, 1000)), 1000 * 99) && CheckBits(circuit.Evaluate(InputBits(77, 321)), 77 * 321);
+}
+
+bool TestRecordingDivision() {
+    Circuit circuit;
+    GenericInt32<RecordedBit> a(1000), b(99), c(0);
+    a.Initialize(circuit);
+    b.Initialize(circuit);
+
+    c = a / b;
+    circuit.AddOutput(c);
+
+    cout<<circuit.GetGateCount()<<" "<<circuit.GetDepth()<<endl;
+
+    return CheckBits(circuit.Evaluate(InputBits(1000, 99)), 1000 / 99) && CheckBits(circuit.Evaluate(InputBits(65535, 17)), 65535 / 17);
+}
+
+int main(){
+    bool flag = true;
+
+    flag &= Report(TestRecordingAddition());
+    flag &= Report(TestRecordingMultiplication());
+    flag &= Report(TestRecordingDivision());
+
+    return flag ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+#ifndef HOMOMORPHIC_ENCRYPTION_TEST_REPORT_H
+#define HOMOMORPHIC_ENCRYPTION_TEST_REPORT_H
+
+#include <iostream>
+
+// Prints the 0/1 result of a test on its own line and passes it on, so that main shows
+// every result and still exits with a failure status when one of them is 0
+inline bool Report(bool passed) {
+    std::cout<<passed<<std::endl;
+    return passed;
+}
+
+#endif
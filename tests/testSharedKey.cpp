@@ -0,0 +1,96 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+FheContext context;
+
+// Every coefficient reached through the mapped skeleton matches the generated key
+bool TestSharedKeyContents() {
+    FheContext evaluator;
+
+    if(!context.SaveSharedCloudKey("testSharedKey.key") || !evaluator.MapCloudKey("testSharedKey.key")) {
+        return false;
+    }
+    remove("testSharedKey.key");
+
+    const LweBootstrappingKeyFFT *original = context.cloudKey->bkFFT, *mapped = evaluator.cloudKey->bkFFT;
+    int n = original->in_out_params->n, N = original->accum_params->N, k = original->accum_params->k, l = original->bk_params->l;
+    bool flag = !evaluator.HasSecretKey() && mapped->in_out_params->n == n && mapped->accum_params->N == N;
+
+    for(int i = 0; i < n; i++) {
+        for(int j = 0; j < (k + 1) * l; j++) {
+            for(int p = 0; p <= k; p++) {
+                flag &= memcmp(original->bkFFT[i].all_samples[j].a[p].data, mapped->bkFFT[i].all_samples[j].a[p].data, N * sizeof(double)) == 0;
+            }
+        }
+    }
+
+    const LweKeySwitchKey *ks = original->ks, *mappedKs = mapped->ks;
+    flag &= ks->n == mappedKs->n && ks->t == mappedKs->t && ks->base == mappedKs->base;
+
+    for(int i = 0; i < ks->n; i++) {
+        for(int j = 0; j < ks->t; j++) {
+            for(int h = 0; h < ks->base; h++) {
+                const LweSample &a = ks->ks[i][j][h], &b = mappedKs->ks[i][j][h];
+                flag &= a.b == b.b && a.current_variance == b.current_variance
+                    && memcmp(a.a, b.a, ks->out_params->n * sizeof(Torus32)) == 0;
+            }
+        }
+    }
+
+    return flag;
+}
+
+// Gates evaluated against the mapped key decrypt correctly under the client's secret key
+bool TestSharedKeyGates() {
+    FheContext evaluator;
+
+    if(!context.SaveSharedCloudKey("testSharedKey.key") || !evaluator.MapCloudKey("testSharedKey.key")) {
+        return false;
+    }
+    remove("testSharedKey.key");
+
+    RealGateBootstrappedBit a, b;
+    a.Initialize(1, context);
+    b.Initialize(0, context);
+
+    RealGateBootstrappedBit x(evaluator, uninitialized), y(evaluator, uninitialized);
+    bootsCOPY(x.value, a.value, evaluator.cloudKey);
+    bootsCOPY(y.value, b.value, evaluator.cloudKey);
+
+    RealGateBootstrappedBit conjunction = x & y, disjunction = x | y, selected = mux(x, y, x);
+
+    return !context.Decrypt(conjunction.value) && context.Decrypt(disjunction.value) && !context.Decrypt(selected.value);
+}
+
+bool TestRejectsBadFile() {
+    FheContext evaluator;
+    FILE *file = fopen("testSharedKey.bad", "wb");
+    fputs("not a key", file);
+    fclose(file);
+
+    bool mapped = evaluator.MapCloudKey("testSharedKey.bad");
+    remove("testSharedKey.bad");
+
+    return !mapped && evaluator.cloudKey == NULL && !evaluator.MapCloudKey("testSharedKey.missing");
+}
+
+int main() {
+    bool flag = true;
+
+    context.Generate();
+
+    flag &= Report(TestSharedKeyContents());
+    flag &= Report(TestSharedKeyGates());
+    flag &= Report(TestRejectsBadFile());
+    return flag ? 0 : 1;
+}
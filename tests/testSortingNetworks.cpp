@@ -0,0 +1,237 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/sortingNetworks.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+FheContext context;
+
+template <int N>
+long long Value(const GenericInt<N, bool> &a) {
+    long long value = 0;
+
+    for(int i = N - 1; i >= 0; i--) {
+        value = value * 2 + a.encValue[i];
+    }
+
+    return value;
+}
+
+template <int N>
+long long Value(const GenericInt<N, RealGateBootstrappedBit> &a) {
+    long long value = 0;
+
+    for(int i = N - 1; i >= 0; i--) {
+        value = value * 2 + a.encValue[i].Decrypt();
+    }
+
+    return value;
+}
+
+// Stages only touch each position once and every comparator points forward
+bool WellFormed(const SortingNetwork &network, int n) {
+    bool flag = true;
+
+    for(size_t s = 0; s < network.size(); s++) {
+        vector<bool> used(n, false);
+
+        for(size_t c = 0; c < network[s].size(); c++) {
+            int low = network[s][c].low, high = network[s][c].high;
+
+            flag &= 0 <= low && low < high && high < n && !used[low] && !used[high];
+            used[low] = used[high] = true;
+        }
+    }
+
+    return flag;
+}
+
+// A network sorts everything if it sorts every sequence of zeros and ones; for top-k only
+// the first k positions have to come out right
+bool SortsZeroOne(const SortingNetwork &network, int n, int k) {
+    for(int mask = 0; mask < (1 << n); mask++) {
+        vector<int> values(n);
+
+        for(int i = 0; i < n; i++) {
+            values[i] = (mask >> i) & 1;
+        }
+
+        for(size_t s = 0; s < network.size(); s++) {
+            for(size_t c = 0; c < network[s].size(); c++) {
+                if(values[network[s][c].low] > values[network[s][c].high]) {
+                    swap(values[network[s][c].low], values[network[s][c].high]);
+                }
+            }
+        }
+
+        int zeros = n - __builtin_popcount(mask);
+
+        for(int i = 0; i < k; i++) {
+            if(values[i] != (i < zeros ? 0 : 1) || (i > 0 && values[i] < values[i - 1])) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool TestNetworks() {
+    bool flag = true;
+
+    for(int n = 1; n <= 14; n++) {
+        SortingNetwork bitonic = BitonicNetwork(n), oddEven = OddEvenMergeNetwork(n);
+
+        flag &= WellFormed(bitonic, n) && SortsZeroOne(bitonic, n, n);
+        flag &= WellFormed(oddEven, n) && SortsZeroOne(oddEven, n, n);
+
+        for(int k = 1; k <= n; k++) {
+            SortingNetwork top = TopKNetwork(n, k);
+            flag &= WellFormed(top, n) && SortsZeroOne(top, n, k);
+        }
+    }
+
+    SortingNetwork bitonic = BitonicNetwork(1024), oddEven = OddEvenMergeNetwork(1024), top = TopKNetwork(1024, 8);
+
+    cout<<bitonic.size()<<" "<<GetComparatorCount(bitonic)<<" "<<oddEven.size()<<" "<<GetComparatorCount(oddEven)
+        <<" "<<top.size()<<" "<<GetComparatorCount(top)<<endl;
+
+    return flag && bitonic.size() == 55 && GetComparatorCount(bitonic) == 28160 && oddEven.size() == 55 && GetComparatorCount(oddEven) == 24063;
+}
+
+bool TestSortValues() {
+    bool flag = true;
+
+    for(int n = 1; n <= 40; n += 3) {
+        vector<GenericInt32<bool> > a(n), b(n);
+        vector<int> expected(n);
+
+        for(int i = 0; i < n; i++) {
+            expected[i] = rand() % 1000;
+            a[i] = b[i] = GenericInt32<bool>(expected[i]);
+        }
+
+        sort(expected.begin(), expected.end());
+        bitonicSort(a);
+        oddEvenMergeSort(b, true);
+
+        for(int i = 0; i < n; i++) {
+            flag &= Value(a[i]) == expected[i] && Value(b[i]) == expected[n - 1 - i];
+        }
+    }
+
+    return flag;
+}
+
+// Payloads travel with their keys
+bool TestSortByKey() {
+    vector<GenericInt<8, bool> > keys(23);
+    vector<GenericInt32<bool> > payloads(23);
+    bool flag = true;
+
+    for(int i = 0; i < 23; i++) {
+        keys[i] = GenericInt<8, bool>(rand() % 200);
+        payloads[i] = GenericInt32<bool>(Value(keys[i]) * 1000 + 7);
+    }
+
+    sortByKey(keys, payloads);
+
+    for(int i = 0; i < 23; i++) {
+        flag &= Value(payloads[i]) == Value(keys[i]) * 1000 + 7 && (i == 0 || Value(keys[i - 1]) <= Value(keys[i]));
+    }
+
+    return flag;
+}
+
+bool TestTopK() {
+    vector<GenericInt32<bool> > values(50);
+    vector<int> expected(50);
+    bool flag = true;
+
+    for(int i = 0; i < 50; i++) {
+        expected[i] = rand() % 10000;
+        values[i] = GenericInt32<bool>(expected[i]);
+    }
+
+    sort(expected.begin(), expected.end());
+
+    vector<GenericInt32<bool> > largest = topK(values, 5), smallest = topK(values, 3, false);
+
+    flag &= largest.size() == 5 && smallest.size() == 3;
+
+    for(int i = 0; i < 5; i++) {
+        flag &= Value(largest[i]) == expected[49 - i];
+    }
+
+    for(int i = 0; i < 3; i++) {
+        flag &= Value(smallest[i]) == expected[i];
+    }
+
+    return flag;
+}
+
+// Both networks have the same number of stages, so their recorded sorts are equally deep,
+// and odd-even merging gets there with fewer comparators
+bool TestRecordedDepth() {
+    Circuit bitonic, oddEven;
+    vector<GenericInt<8, RecordedBit> > a(16), b(16);
+
+    for(int i = 0; i < 16; i++) {
+        a[i].Initialize(0, bitonic);
+        b[i].Initialize(0, oddEven);
+    }
+
+    bitonicSort(a);
+    oddEvenMergeSort(b);
+
+    for(int i = 0; i < 16; i++) {
+        bitonic.AddOutput(a[i]);
+        oddEven.AddOutput(b[i]);
+    }
+
+    cout<<bitonic.GetBootstrapping()<<" "<<bitonic.GetDepth()<<" "<<oddEven.GetBootstrapping()<<" "<<oddEven.GetDepth()<<endl;
+
+    return oddEven.GetBootstrapping() < bitonic.GetBootstrapping() && bitonic.GetDepth() == oddEven.GetDepth();
+}
+
+// Stages run on the pool one comparator per task
+bool TestParallelSort() {
+    WorkStealingPool pool(4);
+    vector<GenericInt<4, RealGateBootstrappedBit> > values(6);
+    int plain[6] = {9, 3, 14, 0, 7, 3};
+    bool flag = true;
+
+    for(int i = 0; i < 6; i++) {
+        values[i].Initialize(plain[i], context);
+    }
+
+    applyNetwork(values, OddEvenMergeNetwork(6), pool);
+    sort(plain, plain + 6);
+
+    for(int i = 0; i < 6; i++) {
+        flag &= Value(values[i]) == plain[i];
+    }
+
+    return flag;
+}
+
+int main() {
+    bool flag = true;
+
+    context.Generate();
+
+    flag &= Report(TestNetworks());
+    flag &= Report(TestSortValues());
+    flag &= Report(TestSortByKey());
+    flag &= Report(TestTopK());
+    flag &= Report(TestRecordedDepth());
+    flag &= Report(TestParallelSort());
+    return flag ? 0 : 1;
+}
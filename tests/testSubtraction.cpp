@@ -4,6 +4,7 @@
 #include <tfhe/tfhe.h>
 #include <tfhe/tfhe_io.h>
 #include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
 
 using namespace std;
 using namespace homomorphicEvaluation;
@@ -43,8 +44,6 @@ bool TestSubtraction() {
         real /= 2;
     }
 
-    cout<<cycle.GetBootstrapping()<<endl;
-
     return flag;
 }
 
@@ -66,15 +65,15 @@ bool TestSubtractionCircuit() {
         real /= 2;
     }
 
-    cout<<cycle.GetBootstrapping()<<endl;
-
     return flag;
 }
 
 int main(){
-    cout<<TestSubtractionBool()<<endl;
-    cout<<TestSubtraction()<<endl;
-    cout<<TestSubtractionCircuit()<<endl;
+    bool flag = true;
+
+    flag &= Report(TestSubtractionBool());
+    flag &= Report(TestSubtraction());
+    flag &= Report(TestSubtractionCircuit());
 
-    return 0;
+    return flag ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <tfhe/tfhe.h>
+#include <tfhe/tfhe_io.h>
+#include "../include/homomorphicEvaluation.h"
+#include "testReport.h"
+
+using namespace std;
+using namespace homomorphicEvaluation;
+
+template <int N>
+unsigned long long Value(const GenericInt<N, bool> &a) {
+    unsigned long long ans = 0;
+
+    for(int i = N - 1; i >= 0; i--) {
+        ans *= 2;
+        ans += a.encValue[i];
+    }
+
+    return ans;
+}
+
+bool TestArithmetic8Bool() {
+    bool flag = true;
+
+    for(int p = 0; p < 256; p += 7) {
+        for(int q = 1; q < 256; q += 11) {
+            GenericInt8<bool> a(p), b(q);
+
+            flag &= (Value(a + b) == (unsigned char)(p + q));
+            flag &= (Value(a - b) == (unsigned char)(p - q));
+            flag &= (Value(a * b) == (unsigned char)(p * q));
+            flag &= (Value(a / b) == (unsigned char)(p / q));
+            flag &= (Value(a % b) == (unsigned char)(p % q));
+            flag &= ((a < b) == (p < q));
+        }
+    }
+
+    return flag;
+}
+
+bool TestConversionsBool() {
+    GenericInt16<bool> a(-300), b(1000);
+
+    bool flag = (Value(a) == 65236);
+    flag &= (Value(a.ZeroExtend<32>()) == 65236);
+    flag &= (Value(a.SignExtend<32>()) == 4294966996u);
+    flag &= (Value(b.SignExtend<64>()) == 1000);
+    flag &= (Value(b.Truncate<8>()) == 232);
+
+    return flag;
+}
+
+long long MultiplicationBootstraps8() {
+    Computation cycle;
+    GenericInt8<SimulatedGateBootstrappedBit> a, b, c;
+    a.Initialize(99, cycle);
+    b.Initialize(7, cycle);
+
+    c = a * b;
+
+    return cycle.GetBootstrapping();
+}
+
+long long MultiplicationBootstraps32() {
+    Computation cycle;
+    GenericInt32<SimulatedGateBootstrappedBit> a, b, c;
+    a.Initialize(99, cycle);
+    b.Initialize(7, cycle);
+
+    c = a * b;
+
+    return cycle.GetBootstrapping();
+}
+
+int main(){
+    bool flag = true;
+
+    flag &= Report(TestArithmetic8Bool());
+    flag &= Report(TestConversionsBool());
+    cout<<MultiplicationBootstraps8()<<" "<<MultiplicationBootstraps32()<<endl;
+
+    return flag ? 0 : 1;
+}